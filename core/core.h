@@ -11,6 +11,9 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <span>
+#include <memory>
+#include <algorithm>
 
 #include <glm/glm.hpp>
 #include <glm/mat4x4.hpp>
@@ -23,6 +26,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "object/render/shader.h"
+#include "thread/job_pool.h"
 
 namespace core {
 GLFWwindow* window;
@@ -31,6 +35,11 @@ float deltaTime = 0;
 }
 
 #include "object/vertex.h"
+#include "math/support.h"
+#include "math/quickhull.h"
+#include "math/shape.h"
+#include "math/aabb.h"
+#include "object/collider.h"
 
 #include "object/object.h"
 #include "object/camera.h"
@@ -42,11 +51,21 @@ float deltaTime = 0;
 
 #include "math/raycast.h"
 #include "math/simplex.h"
-#include "math/support.h"
+#include "math/signed_volume.h"
 #include "math/epa.h"
 #include "math/gjk.h"
+#include "math/gjk_distance.h"
+#include "math/manifold.h"
+#include "math/collide.h"
+#include "math/narrow_phase.h"
 
 #include "object/octree_node.h"
+#include "object/octree_snapshot.h"
+#include "object/linear_octree.h"
+#include "object/aabb_tree.h"
+#include "object/sweep_and_prune.h"
+#include "math/triangle_bvh.h"
+#include "math/ray_packet.h"
 
 
 namespace core {
@@ -59,10 +78,11 @@ void renderDebugCube(RObject* object) {
     //object->Render(shader, GL_LINES, true);
 }
 
-std::vector<core::Triangle> BuildTrianglesFromRObject(RObject* obj) {
+// triangles of the mesh as authored, before the model matrix
+std::vector<core::Triangle> BuildLocalTriangles(RObject* obj) {
     std::vector<core::Triangle> tris;
 
-    std::vector<Vertex> verts = obj->GetColliderVertices();
+    const std::vector<Vertex>& verts = obj->vertices;
     const std::vector<uint32_t>& indices = obj->indices;
 
     if (!indices.empty()) {
@@ -126,9 +146,15 @@ void initialize() {
         }
     }
     
+    // terrain colliders never move, they are queried through a lock-free snapshot
+    core::OctreeNode* staticOctreeRoot = new core::OctreeNode(rootOctree->min, rootOctree->max);
     for (RObject* collider : static_cast<Terrain*>(terrain)->colliders) {
-        core::InsertObject(rootOctree, collider);
+        core::InsertObject(staticOctreeRoot, collider);
     }
+    StaticOctree staticOctree;
+    staticOctree.Publish(BuildOctreeSnapshot(staticOctreeRoot));
+    delete staticOctreeRoot;
+    
     for (RObject* cube : colliderCubes) {
         core::InsertObject(rootOctree, cube);
     }
@@ -147,8 +173,32 @@ void initialize() {
     debugRaycastCube->position = glm::vec3(0.0f, 0.0f, -40.0f);
     debugRaycastCube->color = glm::vec3(0.8f);
     
+    // built once in local space, rays are moved into the cube's space instead
+    TriangleBVH debugRaycastBVH(BuildLocalTriangles(debugRaycastCube));
+    
+    // every packet kernel this CPU runs has to agree with the single ray traversal
+    RayPacketCheck packetCheck = CheckRayPacketKernels(debugRaycastBVH);
+    if (packetCheck.mismatches > 0) std::cout << "Ray packets: " << packetCheck.mismatches << " of " << packetCheck.rays << " rays disagree with the single ray traversal\n";
+    
     shader = Shader::Create("/Users/dmitriwamback/Documents/Projects/GJK/GJK/shader/main");
 
+    JobPool jobPool;
+    ParallelOctreeQuery octreeQuery(jobPool);
+    
+#ifdef GJK_BENCHMARK
+    // std::async baseline against the job pool, build with -DGJK_BENCHMARK to measure
+    OctreeQueryBenchmark queryBenchmark = BenchmarkOctreeQuery(rootOctree, octreeQuery, 1000, 40.0f);
+    std::cout << "Octree Query: std::async " << queryBenchmark.referenceMicroseconds << "us, job pool " << queryBenchmark.poolMicroseconds << "us, " << queryBenchmark.mismatches << " mismatches\n";
+#endif
+    
+    GJKPairCache gjkCache;
+    ParallelNarrowPhase narrowPhase(jobPool, 64, &gjkCache);
+    ManifoldCache manifoldCache;
+    std::vector<RObject*> candidates;
+    std::vector<CollisionPair> pairs;
+    std::vector<PairContact> contacts;
+    std::vector<collision> pairCollisions;
+
     double lastFrameTime = glfwGetTime();
     double fpsTimer = lastFrameTime;
     int frameCount = 0;
@@ -212,25 +262,45 @@ void initialize() {
         
         std::cout << static_cast<Terrain*>(terrain)->colliders.size() << "\n";
         
+        glm::vec3 previousPosition = camera.position;
         camera.Update(movement, up, down);
 
-        std::vector<RObject*> candidates;
-        glm::vec3 queryMin = camera.position - glm::vec3(camera.speed * 1.5f) * 0.5f;
-        glm::vec3 queryMax = camera.position + glm::vec3(camera.speed * 1.5f) * 0.5f;
+        // the query box covers the whole step, so the sweep below sees everything on the way
+        glm::vec3 queryMin = glm::min(previousPosition, camera.position) - glm::vec3(camera.speed * 1.5f) * 0.5f;
+        glm::vec3 queryMax = glm::max(previousPosition, camera.position) + glm::vec3(camera.speed * 1.5f) * 0.5f;
 
-        if (rootOctree->children[0]) {
-            candidates = core::ParallelQuery(rootOctree, queryMin, queryMax);
-        }
-        else {
-            core::QueryObjects(rootOctree, queryMin, queryMax, candidates);
+        octreeQuery.Query(rootOctree, queryMin, queryMax, candidates);
+        staticOctree.QueryObjects(queryMin, queryMax, candidates);
+        
+        // sweep the camera over its step so a large step at a low frame rate can't pass through thin
+        // colliders, stop just short of the first hit and slide along it with the rest of the step
+        glm::vec3 sweep = camera.position - previousPosition;
+        float sweepLength = glm::length(sweep);
+        if (sweepLength > 0.0f) {
+            ColliderView cameraStart{&camera.shape, ColliderTransform{}};
+            cameraStart.transform.translation = previousPosition;
+            
+            CastHit first{1.0f, glm::vec3(0.0f), glm::vec3(0.0f), 0};
+            for (RObject* candidate : candidates) {
+                CastHit hit;
+                // a zero normal means the camera already overlaps, the push out below handles that
+                if (GJKRaycastCCD(cameraStart, sweep, candidate->GetCollider(), hit) && hit.normal != glm::vec3(0.0f) && hit.toi < first.toi) first = hit;
+            }
+            
+            if (first.toi < 1.0f) {
+                float toi = std::max(first.toi - 0.01f / sweepLength, 0.0f);
+                glm::vec3 remaining = sweep * (1.0f - toi);
+                remaining -= std::min(glm::dot(remaining, first.normal), 0.0f) * first.normal;
+                camera.position = previousPosition + sweep * toi + remaining;
+            }
         }
         
-        std::optional<Intersection> intersect = Raycast(Ray{camera.position, camera.mouseRayDirection}, BuildTrianglesFromRObject(debugRaycastCube));
+        std::optional<Intersection> intersect = Raycast(Ray{camera.position, camera.mouseRayDirection}, debugRaycastBVH, debugRaycastCube->GetColliderTransform());
         
         if (intersect) {
             debugRaycastCube->color = glm::vec3(0.0f, 0.0f, 0.9f);
             mouseRayCube->position = intersect->intersectionPoint;
-            collision col = GJKCollision(mouseRayCube, debugRaycastCube);
+            collision col = CollideShapes(mouseRayCube, debugRaycastCube);
             
             if (col.collided) {
                 if (glm::dot(col.normal, mouseRayCube->position - debugRaycastCube->position) < 0) col.normal = -col.normal;
@@ -241,9 +311,26 @@ void initialize() {
             debugRaycastCube->color = glm::vec3(0.8f);
         }
 
-        for (RObject *_cube : candidates) {
-            collision col = GJKCollision(_cube, mouseRayCube);
-            collision cameraCol = GJKCollisionWithCamera(_cube);
+        pairs.clear();
+        for (RObject *_cube : candidates) pairs.push_back(CollisionPair{_cube, mouseRayCube});
+        narrowPhase.Collide(pairs, contacts);
+        gjkCache.NextFrame();
+        gjkCache.ResetStats();
+        pairCollisions.assign(pairs.size(), collision{});
+        for (const PairContact& contact : contacts) pairCollisions[contact.pair] = contact.contact;
+
+        for (const PairContact& contact : contacts) {
+            const CollisionPair& pair = pairs[contact.pair];
+            ContactManifold manifold;
+            if (BuildShapeManifold(pair.a->GetCollider(), pair.b->GetCollider(), contact.contact, manifold)) manifoldCache.Update(pair, manifold);
+        }
+        manifoldCache.NextFrame();
+        manifoldCache.ResetStats();
+
+        for (size_t i = 0; i < candidates.size(); i++) {
+            RObject *_cube = candidates[i];
+            collision col = pairCollisions[i];
+            collision cameraCol = CollideShapes(_cube->GetCollider(), camera.GetCollider());
             
             bool collidedWithCube = false;
 
@@ -0,0 +1,38 @@
+//
+//  aabb.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-27.
+//
+
+#ifndef aabb_h
+#define aabb_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Axis aligned boxes
+//------------------------------------------------------------------------------------------//
+
+// touching boxes count as overlapping
+inline bool AABBOverlaps(const glm::vec3& amin, const glm::vec3& amax, const glm::vec3& bmin, const glm::vec3& bmax) {
+    return (amin.x <= bmax.x && amax.x >= bmin.x) &&
+           (amin.y <= bmax.y && amax.y >= bmin.y) &&
+           (amin.z <= bmax.z && amax.z >= bmin.z);
+}
+
+// b lies inside a
+inline bool AABBContains(const glm::vec3& amin, const glm::vec3& amax, const glm::vec3& bmin, const glm::vec3& bmax) {
+    return (bmin.x >= amin.x && bmax.x <= amax.x) &&
+           (bmin.y >= amin.y && bmax.y <= amax.y) &&
+           (bmin.z >= amin.z && bmax.z <= amax.z);
+}
+
+inline float AABBSurfaceArea(const glm::vec3& min, const glm::vec3& max) {
+    glm::vec3 d = max - min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+}
+
+#endif /* aabb_h */
@@ -0,0 +1,356 @@
+//
+//  collide.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-24.
+//
+
+#ifndef collide_h
+#define collide_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Helpers
+//------------------------------------------------------------------------------------------//
+
+// the closed forms need spheres and capsules to stay round, anything stretched falls back to GJK
+bool UniformScale(const glm::vec3& scale) {
+    float tolerance = 1e-5f * std::max(std::abs(scale.x), std::max(std::abs(scale.y), std::abs(scale.z)));
+    return std::abs(scale.x - scale.y) <= tolerance && std::abs(scale.x - scale.z) <= tolerance;
+}
+
+// any unit vector perpendicular to v
+glm::vec3 AnyPerpendicular(const glm::vec3& v) {
+    glm::vec3 axis = std::abs(v.x) < 0.577f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    return glm::normalize(glm::cross(v, axis));
+}
+
+collision NoCollision() {
+    collision result{};
+    result.collided = false;
+    return result;
+}
+
+collision Contact(const glm::vec3& normal, float depth) {
+    collision result{};
+    result.normal = normal;
+    result.depth = depth;
+    result.collided = true;
+    return result;
+}
+
+//------------------------------------------------------------------------------------------//
+// Spheres and capsules
+//------------------------------------------------------------------------------------------//
+
+collision CollideSpheres(const glm::vec3& centerA, float radiusA, const glm::vec3& centerB, float radiusB) {
+
+    glm::vec3 d = centerB - centerA;
+    float radius = radiusA + radiusB;
+    float distance2 = glm::dot(d, d);
+    if (distance2 >= radius * radius) return NoCollision();
+
+    float distance = std::sqrt(distance2);
+    glm::vec3 normal = distance > 1e-6f ? d / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+    return Contact(normal, radius - distance);
+}
+
+// A capsule is the sphere swept along its axis segment, two capsules touch where the closest
+// points of the segments are less than the summed radii apart
+collision CollideCapsules(const glm::vec3& pA, const glm::vec3& qA, float radiusA, const glm::vec3& pB, const glm::vec3& qB, float radiusB) {
+
+    glm::vec3 onA, onB;
+    ClosestBetweenSegments(pA, qA, pB, qB, onA, onB);
+
+    collision result = CollideSpheres(onA, radiusA, onB, radiusB);
+
+    // crossing axes, push apart along the common perpendicular
+    if (result.collided && glm::length2(onB - onA) <= 1e-12f) {
+        glm::vec3 normal = glm::cross(qA - pA, qB - pB);
+        normal = glm::length2(normal) > 1e-12f ? glm::normalize(normal) : AnyPerpendicular(qA - pA);
+        if (glm::dot(normal, (pB + qB) - (pA + qA)) < 0.0f) normal = -normal;
+        result.normal = normal;
+    }
+    return result;
+}
+
+// sphere against an oriented box, normal from the box to the sphere
+collision CollideBoxSphere(const ColliderTransform& box, const glm::vec3& halfExtents, const glm::vec3& center, float radius) {
+
+    glm::vec3 extents = halfExtents * glm::abs(box.scale);
+    glm::vec3 local = glm::transpose(box.rotation) * (center - box.translation);
+    glm::vec3 closest = glm::clamp(local, -extents, extents);
+
+    glm::vec3 delta = local - closest;
+    float distance2 = glm::dot(delta, delta);
+
+    if (distance2 > 1e-12f) {
+        if (distance2 >= radius * radius) return NoCollision();
+        float distance = std::sqrt(distance2);
+        return Contact(box.rotation * (delta / distance), radius - distance);
+    }
+
+    // the center is inside, leave through the nearest face
+    int axis = 0;
+    float nearest = extents.x - std::abs(local.x);
+    for (int k = 1; k < 3; k++) {
+        float gap = extents[k] - std::abs(local[k]);
+        if (gap < nearest) {
+            nearest = gap;
+            axis = k;
+        }
+    }
+    glm::vec3 normal = glm::vec3(0.0f);
+    normal[axis] = local[axis] >= 0.0f ? 1.0f : -1.0f;
+    return Contact(box.rotation * normal, radius + nearest);
+}
+
+float SphereRadius(const ColliderView& sphere) {
+    return static_cast<const SphereShape*>(sphere.shape)->radius * std::abs(sphere.transform.scale.x);
+}
+
+void CapsuleSegment(const ColliderView& capsule, glm::vec3& p, glm::vec3& q, float& radius) {
+    const CapsuleShape* shape = static_cast<const CapsuleShape*>(capsule.shape);
+    p = capsule.transform.ToWorldPoint(glm::vec3(0.0f, -shape->halfHeight, 0.0f));
+    q = capsule.transform.ToWorldPoint(glm::vec3(0.0f,  shape->halfHeight, 0.0f));
+    radius = shape->radius * std::abs(capsule.transform.scale.x);
+}
+
+//------------------------------------------------------------------------------------------//
+// Box against box
+//------------------------------------------------------------------------------------------//
+
+// an edge axis only replaces a face axis when it is this much shallower, relative to the depth,
+// so resting boxes do not flip between axes on rounding
+constexpr float SATEdgeBias = 1e-3f;
+
+// edge pairs closer to parallel than this are covered by the face axes
+constexpr float SATParallelTolerance = 1e-6f;
+
+struct BoxAxis {
+    // from A to B
+    glm::vec3 normal;
+    float depth;
+    // 0-2 a face of A, 3-5 a face of B, 6 + 3i + j the edges of A along axis i and B along j
+    int axis;
+};
+
+struct OrientedBox {
+    glm::vec3 center;
+    glm::vec3 axes[3];
+    glm::vec3 extents;
+};
+
+OrientedBox MakeOrientedBox(const ColliderView& collider) {
+
+    const ColliderTransform& transform = collider.transform;
+    OrientedBox box;
+    box.center = transform.translation;
+    for (int i = 0; i < 3; i++) box.axes[i] = transform.rotation[i];
+    box.extents = static_cast<const BoxShape*>(collider.shape)->halfExtents * glm::abs(transform.scale);
+    return box;
+}
+
+// Separating axis test over the 15 candidate axes of two boxes: the 3 face normals of each and
+// the 9 cross products of their edges (Gottschalk, Lin and Manocha, "OBBTree", 1996). Returns
+// false on the first axis that separates them, otherwise the axis of least penetration.
+bool FindBoxAxis(const OrientedBox& a, const OrientedBox& b, BoxAxis& best) {
+
+    glm::vec3 t = b.center - a.center;
+
+    float R[3][3], absR[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            R[i][j] = glm::dot(a.axes[i], b.axes[j]);
+            absR[i][j] = std::abs(R[i][j]);
+        }
+    }
+
+    best.depth = FLT_MAX;
+
+    for (int i = 0; i < 3; i++) {
+        float rb = b.extents.x * absR[i][0] + b.extents.y * absR[i][1] + b.extents.z * absR[i][2];
+        float distance = glm::dot(t, a.axes[i]);
+        float depth = a.extents[i] + rb - std::abs(distance);
+        if (depth < 0.0f) return false;
+        if (depth < best.depth) best = BoxAxis{distance < 0.0f ? -a.axes[i] : a.axes[i], depth, i};
+    }
+
+    for (int j = 0; j < 3; j++) {
+        float ra = a.extents.x * absR[0][j] + a.extents.y * absR[1][j] + a.extents.z * absR[2][j];
+        float distance = glm::dot(t, b.axes[j]);
+        float depth = ra + b.extents[j] - std::abs(distance);
+        if (depth < 0.0f) return false;
+        if (depth < best.depth) best = BoxAxis{distance < 0.0f ? -b.axes[j] : b.axes[j], depth, 3 + j};
+    }
+
+    float faceDepth = best.depth;
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            glm::vec3 axis = glm::cross(a.axes[i], b.axes[j]);
+            float length2 = glm::dot(axis, axis);
+            if (length2 < SATParallelTolerance) continue;
+            axis /= std::sqrt(length2);
+
+            float ra = 0.0f, rb = 0.0f;
+            for (int k = 0; k < 3; k++) {
+                ra += a.extents[k] * std::abs(glm::dot(a.axes[k], axis));
+                rb += b.extents[k] * std::abs(glm::dot(b.axes[k], axis));
+            }
+            float distance = glm::dot(t, axis);
+            float depth = ra + rb - std::abs(distance);
+            if (depth < 0.0f) return false;
+            if (depth < best.depth && depth < faceDepth * (1.0f - SATEdgeBias)) {
+                best = BoxAxis{distance < 0.0f ? -axis : axis, depth, 6 + i * 3 + j};
+            }
+        }
+    }
+
+    return true;
+}
+
+collision CollideBoxes(const ColliderView& colliderA, const ColliderView& colliderB) {
+
+    BoxAxis axis;
+    if (!FindBoxAxis(MakeOrientedBox(colliderA), MakeOrientedBox(colliderB), axis)) return NoCollision();
+    return Contact(axis.normal, axis.depth);
+}
+
+// The edge of a box along axis i that lies furthest in direction d
+void SupportEdge(const OrientedBox& box, int i, const glm::vec3& d, glm::vec3& p, glm::vec3& q) {
+
+    glm::vec3 center = box.center;
+    for (int k = 0; k < 3; k++) {
+        if (k == i) continue;
+        center += box.axes[k] * (glm::dot(box.axes[k], d) >= 0.0f ? box.extents[k] : -box.extents[k]);
+    }
+    p = center - box.axes[i] * box.extents[i];
+    q = center + box.axes[i] * box.extents[i];
+}
+
+// SAT contacts: a face axis clips the incident face against the reference face, an edge axis
+// gives the single point between the two crossing edges
+bool BoxManifold(const ColliderView& colliderA, const ColliderView& colliderB, ContactManifold& manifold) {
+
+    manifold.count = 0;
+
+    OrientedBox a = MakeOrientedBox(colliderA);
+    OrientedBox b = MakeOrientedBox(colliderB);
+
+    BoxAxis axis;
+    if (!FindBoxAxis(a, b, axis)) return false;
+
+    if (axis.axis < 6) return BuildContactManifold(colliderA, colliderB, Contact(axis.normal, axis.depth), manifold);
+
+    int i = (axis.axis - 6) / 3, j = (axis.axis - 6) % 3;
+    glm::vec3 pA, qA, pB, qB, onA, onB;
+    SupportEdge(a, i,  axis.normal, pA, qA);
+    SupportEdge(b, j, -axis.normal, pB, qB);
+    ClosestBetweenSegments(pA, qA, pB, qB, onA, onB);
+
+    manifold.normal = axis.normal;
+    manifold.points[0] = ContactPoint{(onA + onB) * 0.5f, axis.depth, 0x40000u | uint32_t(i << 4) | uint32_t(j)};
+    manifold.count = 1;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------//
+// Dispatch
+//------------------------------------------------------------------------------------------//
+
+// Kernels with the GJKKernel signature, so they drop into the same table. None of them iterate:
+// the cached search direction is left alone and iterations is not advanced.
+collision BoxBoxKernel(const ColliderView& a, const ColliderView& b, glm::vec3&, int&, int) {
+    return CollideBoxes(a, b);
+}
+
+collision SphereSphereKernel(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations) {
+
+    if (!UniformScale(a.transform.scale) || !UniformScale(b.transform.scale)) {
+        return GJK<SphereShape, SphereShape>::Collide(a, b, direction, iterations, maxIterations);
+    }
+    return CollideSpheres(a.transform.translation, SphereRadius(a), b.transform.translation, SphereRadius(b));
+}
+
+collision BoxSphereKernel(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations) {
+
+    if (!UniformScale(b.transform.scale)) return GJK<BoxShape, SphereShape>::Collide(a, b, direction, iterations, maxIterations);
+    return CollideBoxSphere(a.transform, static_cast<const BoxShape*>(a.shape)->halfExtents, b.transform.translation, SphereRadius(b));
+}
+
+collision SphereBoxKernel(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations) {
+
+    if (!UniformScale(a.transform.scale)) return GJK<SphereShape, BoxShape>::Collide(a, b, direction, iterations, maxIterations);
+
+    collision result = CollideBoxSphere(b.transform, static_cast<const BoxShape*>(b.shape)->halfExtents, a.transform.translation, SphereRadius(a));
+    result.normal = -result.normal;
+    return result;
+}
+
+collision CapsuleCapsuleKernel(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations) {
+
+    if (!UniformScale(a.transform.scale) || !UniformScale(b.transform.scale)) {
+        return GJK<CapsuleShape, CapsuleShape>::Collide(a, b, direction, iterations, maxIterations);
+    }
+
+    glm::vec3 pA, qA, pB, qB;
+    float radiusA, radiusB;
+    CapsuleSegment(a, pA, qA, radiusA);
+    CapsuleSegment(b, pB, qB, radiusB);
+    return CollideCapsules(pA, qA, radiusA, pB, qB, radiusB);
+}
+
+using CollideKernel = collision (*)(const ColliderView&, const ColliderView&, glm::vec3&, int&, int);
+
+constexpr size_t ShapePairIndex(ShapeType a, ShapeType b) {
+    return size_t(a) * ShapeTypeCount + size_t(b);
+}
+
+// the GJK kernels, with the pairs that have an exact test swapped out
+constexpr std::array<CollideKernel, ShapeTypeCount * ShapeTypeCount> MakeCollideKernels() {
+
+    std::array<CollideKernel, ShapeTypeCount * ShapeTypeCount> kernels{};
+    for (size_t i = 0; i < kernels.size(); i++) kernels[i] = GJKKernels[i].collide;
+
+    kernels[ShapePairIndex(ShapeType::Box,     ShapeType::Box)]     = &BoxBoxKernel;
+    kernels[ShapePairIndex(ShapeType::Sphere,  ShapeType::Sphere)]  = &SphereSphereKernel;
+    kernels[ShapePairIndex(ShapeType::Box,     ShapeType::Sphere)]  = &BoxSphereKernel;
+    kernels[ShapePairIndex(ShapeType::Sphere,  ShapeType::Box)]     = &SphereBoxKernel;
+    kernels[ShapePairIndex(ShapeType::Capsule, ShapeType::Capsule)] = &CapsuleCapsuleKernel;
+    return kernels;
+}
+
+constexpr std::array<CollideKernel, ShapeTypeCount * ShapeTypeCount> CollideKernels = MakeCollideKernels();
+
+// Collision query for any pair of shapes: boxes go through SAT, spheres and capsules through
+// their closed forms, and everything else through GJK and EPA. Same result convention as
+// GJKCollision, but the exact paths report the true depth without EPA's tolerance added.
+collision CollideShapes(const ColliderView& colliderA, const ColliderView& colliderB, glm::vec3& direction, int& iterations, int maxIterations = GJKMaxIterations) {
+    return CollideKernels[ShapePairIndex(colliderA.shape->type, colliderB.shape->type)](colliderA, colliderB, direction, iterations, maxIterations);
+}
+
+collision CollideShapes(const ColliderView& colliderA, const ColliderView& colliderB) {
+
+    glm::vec3 direction = glm::vec3(1.0f, 0.0f, 0.0f);
+    int iterations = 0;
+
+    return CollideShapes(colliderA, colliderB, direction, iterations);
+}
+
+collision CollideShapes(RObject* a, RObject* b) {
+    return CollideShapes(a->GetCollider(), b->GetCollider());
+}
+
+// Contacts for a pair CollideShapes reported as colliding. Boxes rerun the SAT so edge against
+// edge gets its crossing point instead of a clipped face.
+bool BuildShapeManifold(const ColliderView& colliderA, const ColliderView& colliderB, const collision& contact, ContactManifold& manifold) {
+
+    if (colliderA.shape->type == ShapeType::Box && colliderB.shape->type == ShapeType::Box) return BoxManifold(colliderA, colliderB, manifold);
+    return BuildContactManifold(colliderA, colliderB, contact, manifold);
+}
+
+}
+
+#endif /* collide_h */
@@ -14,56 +14,177 @@ struct collision {
     glm::vec3 A, B, normal;
     float depth;
     bool collided;
+    // support pairs GJK used on the query, filled in by GJKCollision
+    int iterations = 0;
+    // false when EPA filled its polytope or it stopped being a clean closed mesh before converging,
+    // depth is then only a lower bound
+    bool converged = true;
 };
 
-std::pair<std::vector<glm::vec4>, size_t> GetNormal(std::vector<glm::vec3>& polytope, std::vector<size_t> indices) {
-    
-    std::vector<glm::vec4> normals;
-    size_t min = 0;
-    float mindst = FLT_MAX;
-    
-    for (int i = 0; i < indices.size()/3; i++) {
-        
-        glm::vec3 A = polytope[indices[i*3]];
-        glm::vec3 B = polytope[indices[i*3 + 1]];
-        glm::vec3 C = polytope[indices[i*3 + 2]];
-        
-        glm::vec3 normal = glm::cross(B - A, C - A);
-        
-        float len = glm::length(normal);
-        if (len < 1e-6f)
-            continue;
-        
-        normal = glm::normalize(normal);
-        float dst = dot(normal, A);
-        
-        if (dst < 0) {
-            normal = -normal;
-            dst = -dst;
+//------------------------------------------------------------------------------------------//
+// Polytope
+//------------------------------------------------------------------------------------------//
+
+// a closed triangle mesh over V vertices has 2V - 4 faces, so the faces never run out first
+constexpr uint32_t EPAMaxVertices = 256;
+constexpr uint32_t EPAMaxFaces = 512;
+
+// normal and distance are computed once when the face is created, normal points out of the polytope
+struct EPAFace {
+    uint32_t v[3];
+    glm::vec3 normal;
+    float distance;
+    // bumped when the face is removed, so heap entries made for it go stale before the slot is reused
+    uint32_t generation = 0;
+};
+
+struct EPAHeapEntry {
+    float distance;
+    uint32_t face, generation;
+};
+
+// Fixed-capacity arena reused by every EPA call on a thread, so expanding never allocates. Removed
+// faces give their slot back to a free list, and only the live faces are scanned. Their heap
+// entries are skipped when they reach the top, or dropped all at once when the heap fills up.
+struct EPAPolytope {
+    std::array<glm::vec3, EPAMaxVertices> vertices;
+    std::array<EPAFace, EPAMaxFaces> faces;
+    std::array<uint32_t, EPAMaxFaces> liveFaces, freeFaces;
+    std::array<EPAHeapEntry, EPAMaxFaces> heap;
+    std::array<std::pair<uint32_t, uint32_t>, EPAMaxFaces * 3> horizon;
+    // faceCount is the number of slots ever handed out, the live and free lists split them
+    uint32_t vertexCount = 0, faceCount = 0, liveCount = 0, freeCount = 0, heapSize = 0, horizonCount = 0;
+    // inside the starting tetrahedron and so inside every later polytope
+    glm::vec3 interior;
+
+    void Reset() { vertexCount = faceCount = liveCount = freeCount = heapSize = horizonCount = 0; }
+    bool AddFace(uint32_t a, uint32_t b, uint32_t c);
+    bool Closest(uint32_t& face);
+    bool RemoveVisible(const glm::vec3& point);
+    void AddHorizonEdge(uint32_t a, uint32_t b);
+    void PruneHeap();
+};
+
+inline bool EPAHeapGreater(const EPAHeapEntry& x, const EPAHeapEntry& y) {
+    return x.distance > y.distance;
+}
+
+// false when every face slot is live, or when the face has no area and so no side to be seen from
+bool EPAPolytope::AddFace(uint32_t a, uint32_t b, uint32_t c) {
+
+    if (freeCount == 0 && faceCount == EPAMaxFaces) return false;
+
+    uint32_t index = freeCount > 0 ? freeFaces[--freeCount] : faceCount++;
+    liveFaces[liveCount++] = index;
+
+    EPAFace& face = faces[index];
+    face.v[0] = a; face.v[1] = b; face.v[2] = c;
+
+    // turned away from the interior rather than the origin, which lies on a face when GJK stops
+    // with the origin on the boundary of its tetrahedron
+    glm::vec3 normal = glm::cross(vertices[b] - vertices[a], vertices[c] - vertices[a]);
+    if (glm::dot(normal, vertices[a] - interior) < 0.0f) normal = -normal;
+    float length = glm::length(normal);
+
+    // A sliver can never be the closest face. It keeps the unnormalized normal, which is too short
+    // for a distance but still tells which side of its plane a support point is on, so it is
+    // removed together with its neighbours instead of being left inside the hole.
+    if (length < 1e-6f) {
+        face.normal = normal;
+        face.distance = FLT_MAX;
+        return length > 0.0f;
+    }
+
+    face.normal = normal / length;
+    face.distance = glm::dot(face.normal, vertices[a]);
+
+    // fewer faces are live than there are slots, so dropping the stale entries always makes room
+    if (heapSize == EPAMaxFaces) PruneHeap();
+    heap[heapSize++] = EPAHeapEntry{face.distance, index, face.generation};
+    std::push_heap(heap.begin(), heap.begin() + heapSize, EPAHeapGreater);
+
+    return true;
+}
+
+// the live face closest to the origin, it stays in the heap until it is removed
+bool EPAPolytope::Closest(uint32_t& face) {
+
+    while (heapSize > 0) {
+        if (faces[heap[0].face].generation == heap[0].generation) {
+            face = heap[0].face;
+            return true;
+        }
+        std::pop_heap(heap.begin(), heap.begin() + heapSize, EPAHeapGreater);
+        heapSize--;
+    }
+    return false;
+}
+
+// Removes every face `point` sees, keeping the live list packed, and collects the horizon of the
+// hole they leave behind. False when rounding made the hole something other than a disk: its
+// horizon then passes a vertex twice and the new faces around it would share an edge.
+bool EPAPolytope::RemoveVisible(const glm::vec3& point) {
+
+    horizonCount = 0;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < liveCount; i++) {
+        EPAFace& face = faces[liveFaces[i]];
+        bool visible = face.distance == FLT_MAX ? glm::dot(face.normal, point - vertices[face.v[0]]) > 0.0f : glm::dot(face.normal, point) > face.distance;
+        if (visible) {
+            AddHorizonEdge(face.v[0], face.v[1]);
+            AddHorizonEdge(face.v[1], face.v[2]);
+            AddHorizonEdge(face.v[2], face.v[0]);
+            face.generation++;
+            freeFaces[freeCount++] = liveFaces[i];
+        }
+        else {
+            liveFaces[kept++] = liveFaces[i];
+        }
+    }
+    liveCount = kept;
+
+    for (uint32_t i = 0; i < horizonCount; i++) {
+        for (uint32_t j = i + 1; j < horizonCount; j++) {
+            if (horizon[i].first == horizon[j].first) return false;
         }
-        normals.emplace_back(normal, dst);
-        if (dst < mindst) {
-            min = i;
-            mindst = dst;
+    }
+    return true;
+}
+
+// an edge seen twice is shared by two removed faces, only edges seen once form the horizon
+void EPAPolytope::AddHorizonEdge(uint32_t a, uint32_t b) {
+
+    for (uint32_t i = 0; i < horizonCount; i++) {
+        if (horizon[i].first == b && horizon[i].second == a) {
+            horizon[i] = horizon[--horizonCount];
+            return;
         }
     }
-    return {normals, min};
+    horizon[horizonCount++] = {a, b};
 }
 
-void AddUnique(std::vector<std::pair<size_t, size_t>>& edges, const std::vector<size_t>& faces, size_t a, size_t b) {
-    auto reverse = std::find_if(edges.begin(), edges.end(),
-        [&](const std::pair<size_t, size_t>& edge) {
-            return (edge.first == faces[b] && edge.second == faces[a]);
-        });
+void EPAPolytope::PruneHeap() {
 
-    if (reverse != edges.end()) {
-        edges.erase(reverse);
-    } else {
-        edges.emplace_back(faces[a], faces[b]);
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < heapSize; i++) {
+        if (faces[heap[i].face].generation == heap[i].generation) heap[kept++] = heap[i];
     }
+    heapSize = kept;
+    std::make_heap(heap.begin(), heap.begin() + heapSize, EPAHeapGreater);
+}
+
+//------------------------------------------------------------------------------------------//
+// EPA
+//------------------------------------------------------------------------------------------//
+
+EPAPolytope& ThreadPolytope() {
+    static thread_local EPAPolytope polytope;
+    return polytope;
 }
 
-collision EPA(Simplex& simplex, std::vector<Vertex> colliderA, std::vector<Vertex> colliderB) {
+// ColliderA and ColliderB are ColliderView or TypedCollider, anything Support() accepts
+template<typename ColliderA, typename ColliderB>
+collision EPA(Simplex& simplex, const ColliderA& colliderA, const ColliderB& colliderB) {
     
     collision collisionDetection{};
     collisionDetection.normal = glm::vec3(0.0f);
@@ -72,84 +193,59 @@ collision EPA(Simplex& simplex, std::vector<Vertex> colliderA, std::vector<Verte
     
     if (simplex.size() < 4) return collisionDetection;
     
+    EPAPolytope& polytope = ThreadPolytope();
+    polytope.Reset();
     
-    std::vector<glm::vec3> polytope(simplex.begin(), simplex.end());
-    std::vector<size_t> indices = {
-        0, 1, 2,    0, 3, 1,
-        0, 2, 3,    1, 3, 2
-    };
+    for (const glm::vec3& point : simplex) polytope.vertices[polytope.vertexCount++] = point;
+    polytope.interior = (polytope.vertices[0] + polytope.vertices[1] + polytope.vertices[2] + polytope.vertices[3]) * 0.25f;
+    polytope.AddFace(0, 1, 2);
+    polytope.AddFace(0, 3, 1);
+    polytope.AddFace(0, 2, 3);
+    polytope.AddFace(1, 3, 2);
     
-    auto [normals, minTriangle] = GetNormal(polytope, indices);
-    glm::vec3 min;
+    glm::vec3 min = glm::vec3(0.0f);
     float mindst = FLT_MAX;
+    bool found = false;
+    bool converged = false;
     
-    for(int k = 0; k < 100; k++) {
-        min = glm::vec3(normals[minTriangle]);
-        mindst = normals[minTriangle].w;
+    // every pass adds a vertex, so the vertex arena bounds the loop
+    while (true) {
+        uint32_t closest;
+        if (!polytope.Closest(closest)) break;
+        
+        min = polytope.faces[closest].normal;
+        mindst = polytope.faces[closest].distance;
+        found = true;
         
         glm::vec3 support = Support(colliderA, min) - Support(colliderB, -min);
-        if (glm::length(support) < 1e-6f) break;
         float sdst = glm::dot(min, support);
         
-        if (abs(sdst - mindst) > 0.001f && sdst < 1e6f) {
-            
-            mindst = FLT_MAX;
-            std::vector<std::pair<size_t, size_t>> unique;
-            
-            for (size_t i = 0; i < normals.size(); i++) {
-                if (glm::dot(glm::vec3(normals[i]), support) > normals[i].w) {
-                    size_t index = i*3;
-
-                    AddUnique(unique, indices, index,     index + 1);
-                    AddUnique(unique, indices, index + 1, index + 2);
-                    AddUnique(unique, indices, index + 2, index);
-
-                    indices[index+2] = indices.back();
-                    indices.pop_back();
-                    indices[index+1] = indices.back();
-                    indices.pop_back();
-                    indices[index] = indices.back();
-                    indices.pop_back();
-                    
-                    normals[i] = normals.back();
-                    normals.pop_back();
-
-                    i--;
-                }
-            }
-            std::vector<size_t> faces = std::vector<size_t>();
-            for (auto [i, j] : unique) {
-                faces.push_back(i);
-                faces.push_back(j);
-                faces.push_back(polytope.size());
-            }
-            
-            
-            polytope.push_back(support);
-            
-            auto [newNormals, newMinFace] = GetNormal(polytope, faces);
-            
-            float oldMinDistance = FLT_MAX;
-            for (size_t i = 0; i < normals.size(); i++) {
-                if (normals[i].w < oldMinDistance) {
-                    oldMinDistance = normals[i].w;
-                    minTriangle = i;
-                }
-            }
- 
-            if (newNormals[newMinFace].w < oldMinDistance) {
-                minTriangle = newMinFace + normals.size();
-            }
- 
-            indices.insert(indices.end(), faces.begin(), faces.end());
-            normals.insert(normals.end(), newNormals.begin(), newNormals.end());
+        // converged, the support point lies on the closest face
+        if (glm::length(support) < 1e-6f || std::abs(sdst - mindst) <= 0.001f || sdst >= 1e6f) {
+            converged = true;
+            break;
         }
+        if (polytope.vertexCount == EPAMaxVertices) break;
+        
+        if (!polytope.RemoveVisible(support)) break;
+        
+        uint32_t index = polytope.vertexCount++;
+        polytope.vertices[index] = support;
         
+        // out of face slots, or a face with no area that later points could not remove
+        bool failed = false;
+        for (uint32_t i = 0; i < polytope.horizonCount && !failed; i++) {
+            failed = !polytope.AddFace(polytope.horizon[i].first, polytope.horizon[i].second, index);
+        }
+        if (failed) break;
     }
-     
+    
+    if (!found) return collisionDetection;
+    
     collisionDetection.normal = min;
     collisionDetection.depth = std::min(mindst + 0.001f, 1e2f);
     collisionDetection.collided = true;
+    collisionDetection.converged = converged;
     
     return collisionDetection;
 }
@@ -6,6 +6,9 @@
 #define gjk_h
 
 #include <algorithm>
+#include <unordered_map>
+#include <tuple>
+#include <utility>
 #include <glm/gtx/norm.hpp>
 
 #include "debug_line.h"
@@ -13,198 +16,335 @@
 namespace core {
 
 //------------------------------------------------------------------------------------------//
-// Simplex Line
+// GJK
 //------------------------------------------------------------------------------------------//
 
-bool SimplexLine(Simplex& simplex, glm::vec3& direction) {
-    
-    glm::vec3 A = simplex[0];
-    glm::vec3 B = simplex[1];
-    
-    glm::vec3 AB = B - A;
-    glm::vec3 AO = -A;
+// hard cap on support pairs per query, the loop normally ends well before it
+constexpr int GJKMaxIterations = 32;
+
+// distance queries stop once a step would bring v less than this fraction of |v|^2 closer
+constexpr float GJKRelativeTolerance = 1e-4f;
+
+// shapes whose Minkowski difference reaches less than this fraction of its size past the origin
+// count as touching, not overlapping
+constexpr float GJKTouchTolerance = 1e-5f;
+
+// squared distance, relative to the simplex size, at which the origin lies on the simplex
+constexpr float GJKContactTolerance = 1e-10f;
+
+// a direction off a simplex that (nearly) contains the origin: the normal of a triangle or a
+// perpendicular of a segment, turned to the side of the origin given by the residual v
+glm::vec3 SimplexNormal(const glm::vec3* points, int count, const glm::vec3& v) {
     
-    if (SameDirection(AB, AO)) {
-        direction = glm::cross(glm::cross(AB, AO), AB);
+    glm::vec3 normal = glm::vec3(1.0f, 0.0f, 0.0f);
+    if (count == 3) {
+        normal = glm::cross(points[1] - points[0], points[2] - points[0]);
     }
-    else {
-        simplex = { A };
-        direction = AO;
+    else if (count == 2) {
+        glm::vec3 AB = points[1] - points[0];
+        glm::vec3 axis = std::abs(AB.x) < std::abs(AB.y) ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        normal = glm::cross(AB, axis);
     }
-    
-    return false;
+    return glm::dot(normal, v) > 0.0f ? -normal : normal;
 }
-//------------------------------------------------------------------------------------------//
-// Simplex Triangle
-//------------------------------------------------------------------------------------------//
 
-bool SimplexTriangle(Simplex& simplex, glm::vec3& direction) {
+// Runs the GJK loop until the simplex encloses the origin (true) or a separating axis is found
+// (false). Seeded with `direction`, which is left holding the last search direction: a separating
+// axis when the shapes do not touch. `iterations` counts the support pairs used.
+// Every step moves v, the point of the simplex closest to the origin, with the signed volume
+// solver and searches along -v. When the origin lies on a segment or triangle the simplex is
+// grown off it along its normal. Shapes within the touch tolerance, a repeated support point and
+// a stalled |v| all end the loop with no overlap.
+// ColliderA and ColliderB are ColliderView or TypedCollider, anything Support() accepts.
+template<typename ColliderA, typename ColliderB>
+bool GJKEncloseOrigin(const ColliderA& colliderA, const ColliderB& colliderB, Simplex& simplex, glm::vec3& direction, int& iterations, int maxIterations) {
     
-    glm::vec3 A = simplex[0];
-    glm::vec3 B = simplex[1];
-    glm::vec3 C = simplex[2];
+    if (glm::length2(direction) < 1e-12f) direction = glm::vec3(1.0f, 0.0f, 0.0f);
+    
+    glm::vec3 points[4];
+    points[0] = Support(colliderA, direction) - Support(colliderB, -direction);
+    iterations = 1;
+    
+    // the seed already separates the shapes, common for a cached axis of a separated pair
+    if (glm::dot(points[0], direction) <= 0.0f) {
+        return false;
+    }
     
-    glm::vec3 AB = B - A;
-    glm::vec3 AC = C - A;
-    glm::vec3 AO = -A;
+    int count = 1;
+    glm::vec3 v = points[0];
     
-    glm::vec3 ABC = glm::cross(AB, AC);
+    // squared size of the Minkowski difference seen so far, the scale for the tolerances
+    float size = glm::length2(points[0]);
     
-    if (SameDirection(glm::cross(ABC, AC), AO)) {
-        if (SameDirection(AC, AO)) {
-            simplex = {A,C};
-            direction = glm::cross(glm::cross(AC, AO), AC);
+    for (int i = 0; i < maxIterations; i++) {
+        
+        float vv = glm::dot(v, v);
+        bool onSimplex = vv <= GJKContactTolerance * size;
+        direction = onSimplex ? SimplexNormal(points, count, v) : -v;
+        
+        glm::vec3 va = Support(colliderA,  direction);
+        glm::vec3 vb = Support(colliderB, -direction);
+        glm::vec3 support = va - vb;
+        iterations++;
+        
+        //RenderDebugLine(va, vb, shader);
+
+        float reach = glm::dot(support, direction);
+        if (reach <= 0.0f) {
+            return false;
         }
-        else {
-            return SimplexLine(simplex = {A,B}, direction);
+        // reach / |direction| is how far the shapes can overlap at most, curved shapes in contact would
+        // otherwise creep towards the origin until the iteration cap
+        if (reach * reach <= GJKTouchTolerance * GJKTouchTolerance * size * glm::length2(direction)) {
+            return false;
         }
-    }
-    else {
-        if (SameDirection(glm::cross(AB, ABC), AO)) {
-            return SimplexLine(simplex = {A,B}, direction);
+        for (int j = 0; j < count; j++) {
+            if (points[j] == support) return false;
         }
-        else {
-            if (SameDirection(ABC, AO)) {
-                direction = ABC;
-            }
-            else {
-                simplex = {A, C, B};
-                direction = -ABC;
+
+        points[count++] = support;
+        size = std::max(size, glm::length2(support));
+        
+        // the origin stays on the boundary of the grown simplex, so nothing is dropped until it
+        // is a tetrahedron; reducing could fall back onto the same face over and over
+        if (onSimplex) {
+            if (count == 4) {
+                simplex = {points[0], points[1], points[2], points[3]};
+                return true;
             }
+            v = glm::vec3(0.0f);
+            continue;
+        }
+        
+        SimplexSolution solution = SignedVolumes(points, count);
+        if (solution.count == 4) {
+            simplex = {points[0], points[1], points[2], points[3]};
+            return true;
+        }
+        
+        // rounding stalled the descent
+        glm::vec3 next = SolutionPoint(points, solution);
+        if (glm::dot(next, next) >= vv) {
+            return false;
         }
+        
+        glm::vec3 kept[4];
+        for (int j = 0; j < solution.count; j++) kept[j] = points[solution.indices[j]];
+        std::copy(kept, kept + solution.count, points);
+        count = solution.count;
+        v = next;
     }
 
     return false;
 }
+
 //------------------------------------------------------------------------------------------//
-// Simplex Tetrahedron
+// Shape pair kernels
 //------------------------------------------------------------------------------------------//
 
-bool SimplexTetrahedron(Simplex& simplex, glm::vec3& direction) {
-    
-    glm::vec3 A = simplex[0];
-    glm::vec3 B = simplex[1];
-    glm::vec3 C = simplex[2];
-    glm::vec3 D = simplex[3];
+// GJK and EPA instantiated for one pair of shape types. The loops only see TypedColliders, so
+// every support call is inlined and no virtual call is left in them.
+template<typename ShapeA, typename ShapeB>
+struct GJK {
+    static collision Collide(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations);
+    static bool Intersect(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations);
+};
+
+template<typename ShapeA, typename ShapeB>
+collision GJK<ShapeA, ShapeB>::Collide(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations) {
     
-    glm::vec3 AB = B - A;
-    glm::vec3 AC = C - A;
-    glm::vec3 AD = D - A;
-    glm::vec3 AO = -A;
+    TypedCollider<ShapeA> colliderA(a);
+    TypedCollider<ShapeB> colliderB(b);
     
-    glm::vec3 ABC = glm::cross(AB, AC);
-    glm::vec3 ACD = glm::cross(AC, AD);
-    glm::vec3 ADB = glm::cross(AD, AB);
+    collision collisionInformation{};
+    collisionInformation.collided = false;
     
-    if (SameDirection(ABC, AO)) {
-        return SimplexTriangle(simplex = {A, B, C}, direction);
-    }
-    if (SameDirection(ACD, AO)) {
-        return SimplexTriangle(simplex = {A, C, D}, direction);
-    }
-    if (SameDirection(ADB, AO)) {
-        return SimplexTriangle(simplex = {A, D, B}, direction);
+    Simplex simplex;
+    if (GJKEncloseOrigin(colliderA, colliderB, simplex, direction, iterations, maxIterations)) {
+        collisionInformation = EPA(simplex, colliderA, colliderB);
     }
+    collisionInformation.iterations = iterations;
+    
+    return collisionInformation;
+}
+
+template<typename ShapeA, typename ShapeB>
+bool GJK<ShapeA, ShapeB>::Intersect(const ColliderView& a, const ColliderView& b, glm::vec3& direction, int& iterations, int maxIterations) {
     
+    TypedCollider<ShapeA> colliderA(a);
+    TypedCollider<ShapeB> colliderB(b);
     
-    return true;
+    Simplex simplex;
+    return GJKEncloseOrigin(colliderA, colliderB, simplex, direction, iterations, maxIterations);
 }
 
 //------------------------------------------------------------------------------------------//
-// Simplex
+// Dispatch
 //------------------------------------------------------------------------------------------//
 
-bool HandleSimplex(Simplex& simplex, glm::vec3& direction) {
-    
-    switch (simplex.size()) {
-        case 2: return SimplexLine(simplex, direction);
-        case 3: return SimplexTriangle(simplex, direction);
-        case 4: return SimplexTetrahedron(simplex, direction);
-    }
-    
-    return false;
+// in ShapeType order
+using GJKShapes = std::tuple<BoxShape, SphereShape, CapsuleShape, CylinderShape, ConeShape, HullShape>;
+
+struct GJKKernel {
+    collision (*collide)(const ColliderView&, const ColliderView&, glm::vec3&, int&, int);
+    bool (*intersect)(const ColliderView&, const ColliderView&, glm::vec3&, int&, int);
+};
+
+template<size_t... I>
+constexpr bool GJKShapesInOrder(std::index_sequence<I...>) {
+    return ((std::tuple_element_t<I, GJKShapes>::Type == ShapeType(I)) && ...);
+}
+static_assert(std::tuple_size_v<GJKShapes> == ShapeTypeCount && GJKShapesInOrder(std::make_index_sequence<ShapeTypeCount>{}), "GJKShapes must list every shape in ShapeType order");
+
+// entry a * ShapeTypeCount + b holds the kernels for shape types (a, b)
+template<size_t... I>
+constexpr std::array<GJKKernel, sizeof...(I)> MakeGJKKernels(std::index_sequence<I...>) {
+    return {GJKKernel{
+        &GJK<std::tuple_element_t<I / ShapeTypeCount, GJKShapes>, std::tuple_element_t<I % ShapeTypeCount, GJKShapes>>::Collide,
+        &GJK<std::tuple_element_t<I / ShapeTypeCount, GJKShapes>, std::tuple_element_t<I % ShapeTypeCount, GJKShapes>>::Intersect
+    }...};
+}
+
+constexpr std::array<GJKKernel, ShapeTypeCount * ShapeTypeCount> GJKKernels = MakeGJKKernels(std::make_index_sequence<ShapeTypeCount * ShapeTypeCount>{});
+
+const GJKKernel& FindGJKKernel(const ColliderView& colliderA, const ColliderView& colliderB) {
+    return GJKKernels[size_t(colliderA.shape->type) * ShapeTypeCount + size_t(colliderB.shape->type)];
 }
 
 //------------------------------------------------------------------------------------------//
-// GJK
+// Collision
 //------------------------------------------------------------------------------------------//
 
-collision GJKCollision(RObject* a, RObject* b) {
-    
-    std::vector<Vertex> colliderVerticesA = a->GetColliderVertices();
-    std::vector<Vertex> colliderVerticesB = b->GetColliderVertices();
-    
-    collision collisionInformation{};
-    collisionInformation.collided = false;
-    
-    glm::vec3 support = Support(colliderVerticesA, glm::vec3(1.0f, 0.0f, 0.0f)) - Support(colliderVerticesB, -glm::vec3(1.0f, 0.0f, 0.0f));
+// Full query: EPA runs on overlap to fill in the penetration normal and depth. The pair is
+// dispatched once on its shape types, into the kernel compiled for them.
+collision GJKCollision(const ColliderView& colliderA, const ColliderView& colliderB, glm::vec3& direction, int& iterations, int maxIterations = GJKMaxIterations) {
+    return FindGJKKernel(colliderA, colliderB).collide(colliderA, colliderB, direction, iterations, maxIterations);
+}
+
+collision GJKCollision(const ColliderView& colliderA, const ColliderView& colliderB, int maxIterations = GJKMaxIterations) {
     
-    Simplex simplex;
-    simplex.pushFront(support);
+    glm::vec3 direction = glm::vec3(1.0f, 0.0f, 0.0f);
+    int iterations = 0;
     
-    glm::vec3 direction = -support;
+    return GJKCollision(colliderA, colliderB, direction, iterations, maxIterations);
+}
+
+collision GJKCollision(RObject* a, RObject* b) {
+    return GJKCollision(a->GetCollider(), b->GetCollider());
+}
+
+collision GJKCollisionWithCamera(RObject* a) {
+    return GJKCollision(a->GetCollider(), camera.GetCollider());
+}
+
+//------------------------------------------------------------------------------------------//
+// Intersection
+//------------------------------------------------------------------------------------------//
+
+// Yes/no overlap test for triggers and filtering: stops at the enclosing tetrahedron and never
+// runs EPA. Use GJKCollision when the normal and depth are needed.
+bool GJKIntersect(const ColliderView& colliderA, const ColliderView& colliderB, int& iterations, int maxIterations = GJKMaxIterations) {
     
-    for (int i = 0; i < 10; i++) {
-        glm::vec3 va = Support(colliderVerticesA,  direction);
-        glm::vec3 vb = Support(colliderVerticesB, -direction);
-        support = va - vb;
-        
-        //RenderDebugLine(va, vb, shader);
+    glm::vec3 direction = glm::vec3(1.0f, 0.0f, 0.0f);
+    return FindGJKKernel(colliderA, colliderB).intersect(colliderA, colliderB, direction, iterations, maxIterations);
+}
 
-        if (glm::dot(support, direction) <= 0.0f) {
-            return collisionInformation;
-        }
+bool GJKIntersect(const ColliderView& colliderA, const ColliderView& colliderB) {
+    int iterations = 0;
+    return GJKIntersect(colliderA, colliderB, iterations);
+}
+
+bool GJKIntersect(RObject* a, RObject* b) {
+    return GJKIntersect(a->GetCollider(), b->GetCollider());
+}
 
-        simplex.pushFront(support);
+//------------------------------------------------------------------------------------------//
+// Pairs
+//------------------------------------------------------------------------------------------//
 
-        if (HandleSimplex(simplex, direction)) {
-            collisionInformation = EPA(simplex, a->GetColliderVertices(), b->GetColliderVertices());
-            return collisionInformation;
-        }
+struct CollisionPair {
+    RObject* a;
+    RObject* b;
+};
+
+//------------------------------------------------------------------------------------------//
+// Pair cache
+//------------------------------------------------------------------------------------------//
+
+struct CollisionPairHash {
+    size_t operator()(const CollisionPair& pair) const {
+        size_t h = std::hash<RObject*>()(pair.a);
+        return h ^ (std::hash<RObject*>()(pair.b) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
     }
+};
 
-    std::cout << "Terminated: Max iterations reached. No collision detected.\n";
-    return collisionInformation;
-}
+struct CollisionPairEqual {
+    bool operator()(const CollisionPair& x, const CollisionPair& y) const { return x.a == y.a && x.b == y.b; }
+};
 
-collision GJKCollisionWithCamera(RObject* a) {
+struct GJKCacheEntry {
+    glm::vec3 direction = glm::vec3(1.0f, 0.0f, 0.0f);
+    uint64_t frame = 0;
+};
+
+struct GJKCacheStats {
+    uint64_t queries = 0, hits = 0, iterations = 0;
     
-    collision collisionInformation{};
-    collisionInformation.collided = false;
+    float HitRate() const { return queries ? float(hits) / float(queries) : 0.0f; }
+    float AverageIterations() const { return queries ? float(iterations) / float(queries) : 0.0f; }
+};
+
+// Remembers the last search direction of every (a, b) pair. Objects barely move between frames,
+// so the axis that separated a pair last frame usually separates it again after one support
+// call, and touching pairs start next to their previous terminal simplex. Pairs are ordered:
+// (a, b) and (b, a) are separate entries since their directions are opposite.
+class GJKPairCache {
+public:
+    GJKCacheStats stats;
     
-    std::vector<Vertex> colliderVerticesA = a->GetColliderVertices();
-    std::vector<Vertex> colliderVerticesB = camera.GetColliderVertices();
+    // the entry stays valid until the next NextFrame()
+    GJKCacheEntry& Find(const CollisionPair& pair, bool& hit);
+    // drops the pairs that were not queried during the frame that just ended
+    void NextFrame();
+    void ResetStats() { stats = GJKCacheStats{}; }
+    size_t Size() const { return entries.size(); }
     
-    glm::vec3 support = Support(colliderVerticesA, glm::vec3(1.0f, 0.0f, 0.0f)) - Support(colliderVerticesB, -glm::vec3(1.0f, 0.0f, 0.0f));
+private:
+    std::unordered_map<CollisionPair, GJKCacheEntry, CollisionPairHash, CollisionPairEqual> entries;
+    uint64_t frame = 1;
+};
+
+GJKCacheEntry& GJKPairCache::Find(const CollisionPair& pair, bool& hit) {
     
-    Simplex simplex;
-    simplex.pushFront(support);
+    auto [it, inserted] = entries.try_emplace(pair);
+    hit = !inserted;
+    it->second.frame = frame;
     
-    glm::vec3 direction = -support;
+    stats.queries++;
+    if (hit) stats.hits++;
     
-    for (int i = 0; i < 100; i++) {
-        glm::vec3 va = Support(colliderVerticesA,  direction);
-        glm::vec3 vb = Support(colliderVerticesB, -direction);
-        support = va - vb;
-
-        if (glm::dot(support, direction) <= 0.0f) {
-            return collisionInformation;
-        }
-
-        simplex.pushFront(support);
+    return it->second;
+}
 
-        if (HandleSimplex(simplex, direction)) {
-            collisionInformation = EPA(simplex, a->GetColliderVertices(), camera.GetColliderVertices());
-            return collisionInformation;
-        }
+void GJKPairCache::NextFrame() {
+    
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.frame != frame) it = entries.erase(it);
+        else it++;
     }
-    return collisionInformation;
+    frame++;
 }
 
-bool GJKRaycastCCD() {
+collision GJKCollision(RObject* a, RObject* b, GJKPairCache& cache) {
     
+    bool hit;
+    GJKCacheEntry& entry = cache.Find(CollisionPair{a, b}, hit);
     
-    return false;
+    int iterations = 0;
+    collision col = GJKCollision(a->GetCollider(), b->GetCollider(), entry.direction, iterations);
+    cache.stats.iterations += iterations;
+    
+    return col;
 }
 
 }
@@ -0,0 +1,273 @@
+//
+//  gjk_distance.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-20.
+//
+
+#ifndef gjk_distance_h
+#define gjk_distance_h
+
+namespace core {
+
+// Minkowski difference vertex together with the support points on A and B it came from
+struct SupportPoint {
+    glm::vec3 point, a, b;
+};
+
+// Closest points between two convex shapes. The witness features are the distinct support
+// points of the final simplex on each shape: 1 point is a vertex, 2 an edge, 3 a face.
+struct DistanceResult {
+    glm::vec3 pointA, pointB;
+    // from A towards B, zero when the shapes overlap
+    glm::vec3 normal;
+    float distance;
+    bool overlapping;
+    int iterations;
+
+    std::array<glm::vec3, 3> featureA, featureB;
+    int featureCountA, featureCountB;
+};
+
+//------------------------------------------------------------------------------------------//
+// Closest point on simplex
+//------------------------------------------------------------------------------------------//
+
+// Simplex of support points with the barycentric weights of the point closest to the origin
+struct DistanceSimplex {
+    SupportPoint vertices[4];
+    float weights[4];
+    int count = 0;
+};
+
+SupportPoint MakeSupportPoint(const ColliderView& colliderA, const ColliderView& colliderB, const glm::vec3& direction) {
+
+    SupportPoint support;
+    support.a = Support(colliderA,  direction);
+    support.b = Support(colliderB, -direction);
+    support.point = support.a - support.b;
+    return support;
+}
+
+glm::vec3 SimplexPoint(const DistanceSimplex& simplex) {
+
+    glm::vec3 point = glm::vec3(0.0f);
+    for (int i = 0; i < simplex.count; i++) point += simplex.weights[i] * simplex.vertices[i].point;
+    return point;
+}
+
+// Reduces the simplex to the sub-simplex holding the point closest to the origin, with its
+// weights. Returns false when the origin is inside the tetrahedron.
+bool ClosestOnSimplex(DistanceSimplex& simplex) {
+
+    glm::vec3 points[4];
+    for (int i = 0; i < simplex.count; i++) points[i] = simplex.vertices[i].point;
+
+    SimplexSolution solution = SignedVolumes(points, simplex.count);
+
+    DistanceSimplex reduced;
+    for (int i = 0; i < solution.count; i++) {
+        reduced.vertices[i] = simplex.vertices[solution.indices[i]];
+        reduced.weights[i] = solution.weights[i];
+    }
+    reduced.count = solution.count;
+    simplex = reduced;
+
+    return solution.count < 4;
+}
+
+//------------------------------------------------------------------------------------------//
+// Distance
+//------------------------------------------------------------------------------------------//
+
+// GJK distance (van den Bergen): v is the point of the current simplex closest to the origin and
+// each iteration adds the support point in direction -v. The loop stops once the support point
+// cannot bring v more than `tolerance` closer, so the returned distance is within tolerance.
+DistanceResult GJKDistance(const ColliderView& colliderA, const ColliderView& colliderB, float tolerance = 1e-4f, int maxIterations = 32) {
+
+    DistanceResult result{};
+
+    DistanceSimplex simplex;
+    simplex.vertices[0] = MakeSupportPoint(colliderA, colliderB, glm::vec3(1.0f, 0.0f, 0.0f));
+    simplex.weights[0] = 1.0f;
+    simplex.count = 1;
+
+    glm::vec3 v = simplex.vertices[0].point;
+    result.iterations = 1;
+
+    for (int i = 0; i < maxIterations; i++) {
+
+        float vv = glm::dot(v, v);
+        float size = 0.0f;
+        for (int j = 0; j < simplex.count; j++) size = std::max(size, glm::length2(simplex.vertices[j].point));
+        if (vv <= GJKContactTolerance * size) {
+            result.overlapping = true;
+            break;
+        }
+
+        SupportPoint w = MakeSupportPoint(colliderA, colliderB, -v);
+        result.iterations++;
+
+        // upper bound on how much closer the origin can get, absolute and relative to |v|
+        float progress = vv - glm::dot(v, w.point);
+        if (progress <= tolerance * std::sqrt(vv) || progress <= GJKRelativeTolerance * vv) break;
+
+        bool duplicate = false;
+        for (int j = 0; j < simplex.count; j++) {
+            if (simplex.vertices[j].point == w.point) duplicate = true;
+        }
+        if (duplicate) break;
+
+        DistanceSimplex previous = simplex;
+        simplex.vertices[simplex.count++] = w;
+
+        if (!ClosestOnSimplex(simplex)) {
+            result.overlapping = true;
+            break;
+        }
+
+        glm::vec3 next = SimplexPoint(simplex);
+
+        // rounding can stall the descent, keep the last simplex that made progress
+        if (glm::dot(next, next) >= vv) {
+            simplex = previous;
+            break;
+        }
+        v = next;
+    }
+
+    result.pointA = glm::vec3(0.0f);
+    result.pointB = glm::vec3(0.0f);
+    for (int i = 0; i < simplex.count; i++) {
+        result.pointA += simplex.weights[i] * simplex.vertices[i].a;
+        result.pointB += simplex.weights[i] * simplex.vertices[i].b;
+    }
+
+    result.featureCountA = result.featureCountB = 0;
+    for (int i = 0; i < simplex.count && i < 3; i++) {
+        const SupportPoint& vertex = simplex.vertices[i];
+        if (std::find(result.featureA.begin(), result.featureA.begin() + result.featureCountA, vertex.a) == result.featureA.begin() + result.featureCountA) {
+            result.featureA[result.featureCountA++] = vertex.a;
+        }
+        if (std::find(result.featureB.begin(), result.featureB.begin() + result.featureCountB, vertex.b) == result.featureB.begin() + result.featureCountB) {
+            result.featureB[result.featureCountB++] = vertex.b;
+        }
+    }
+
+    if (result.overlapping) {
+        result.distance = 0.0f;
+        result.normal = glm::vec3(0.0f);
+    }
+    else {
+        result.distance = glm::length(result.pointB - result.pointA);
+        result.normal = result.distance > 0.0f ? (result.pointB - result.pointA) / result.distance : glm::vec3(0.0f);
+    }
+
+    return result;
+}
+
+DistanceResult GJKDistance(RObject* a, RObject* b) {
+    return GJKDistance(a->GetCollider(), b->GetCollider());
+}
+
+//------------------------------------------------------------------------------------------//
+// Shape cast
+//------------------------------------------------------------------------------------------//
+
+struct CastHit {
+    // fraction of the sweep at which the shapes first touch
+    float toi;
+    // contact point on the target and its normal, pointing from the target back at the mover
+    glm::vec3 point, normal;
+    int iterations;
+};
+
+// GJK ray cast (van den Bergen, "Ray Casting against General Convex Objects"): `moving` touches
+// `target` after moving by t * sweep when the ray t * sweep from the origin enters C = target -
+// moving. The ray point x only advances along the sweep, to where the plane with normal v through
+// the latest support point is crossed, so the result is conservative and the loop converges on
+// the first contact. Returns false when the shapes do not meet within the sweep or the loop
+// stops before x reaches C. Shapes that already overlap hit at toi 0 with a zero normal.
+bool GJKRaycastCCD(const ColliderView& moving, const glm::vec3& sweep, const ColliderView& target, CastHit& hit, float tolerance = 1e-4f, int maxIterations = 32) {
+
+    hit = CastHit{};
+
+    float toi = 0.0f;
+    glm::vec3 x = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f);
+
+    // any point of C starts the search, the difference of the two origins is one
+    glm::vec3 v = x - (target.transform.translation - moving.transform.translation);
+    if (glm::length2(v) < 1e-12f) v = -sweep;
+
+    DistanceSimplex simplex;
+
+    // squared size of C seen so far, float error in v grows with it
+    float size = 1.0f;
+
+    int iterations = 0;
+    while (glm::length2(v) > tolerance * tolerance && iterations < maxIterations) {
+
+        SupportPoint support;
+        support.b = Support(target, v);
+        support.a = Support(moving, -v);
+        support.point = x - (support.b - support.a);
+        size = std::max(size, glm::length2(support.b - support.a));
+        iterations++;
+
+        bool advanced = false;
+        float vw = glm::dot(v, support.point);
+        if (vw > 0.0f) {
+            float vr = glm::dot(v, sweep);
+            if (vr >= 0.0f) return false;
+
+            toi -= vw / vr;
+            if (toi > 1.0f) return false;
+
+            x = toi * sweep;
+            normal = v;
+            advanced = true;
+
+            // the simplex is stored relative to x, move it along
+            support.point = x - (support.b - support.a);
+            for (int i = 0; i < simplex.count; i++) {
+                simplex.vertices[i].point = x - (simplex.vertices[i].b - simplex.vertices[i].a);
+            }
+        }
+
+        bool duplicate = false;
+        for (int i = 0; i < simplex.count; i++) {
+            if (simplex.vertices[i].point == support.point) duplicate = true;
+        }
+        if (!duplicate) simplex.vertices[simplex.count++] = support;
+
+        if (!ClosestOnSimplex(simplex)) {
+            v = glm::vec3(0.0f);
+            continue;
+        }
+        v = SimplexPoint(simplex);
+        // a repeated support only means convergence while x stays put, moving x shifts the simplex
+        if (duplicate && !advanced) break;
+    }
+
+    // a repeated support or the iteration cap can end the loop short of the surface, where x has
+    // not reached C and nothing was hit. Large shapes may stall just above the tolerance from float
+    // error alone, so the check scales with them.
+    if (glm::length2(v) > tolerance * tolerance * size) return false;
+
+    hit.toi = toi;
+    hit.normal = glm::length2(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f);
+    hit.point = glm::vec3(0.0f);
+    for (int i = 0; i < simplex.count; i++) hit.point += simplex.weights[i] * simplex.vertices[i].b;
+    hit.iterations = iterations;
+
+    return true;
+}
+
+bool GJKRaycastCCD(RObject* moving, const glm::vec3& sweep, RObject* target, CastHit& hit) {
+    return GJKRaycastCCD(moving->GetCollider(), sweep, target->GetCollider(), hit);
+}
+
+}
+
+#endif /* gjk_distance_h */
@@ -0,0 +1,396 @@
+//
+//  manifold.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-21.
+//
+
+#ifndef manifold_h
+#define manifold_h
+
+#include <unordered_map>
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Contact manifold
+//------------------------------------------------------------------------------------------//
+
+constexpr int MaxManifoldPoints = 4;
+
+// points this far outside the reference face still count as touching
+constexpr float ContactTolerance = 0.005f;
+
+// contacts with no id match are paired with an old contact this close instead
+constexpr float ContactMatchDistance = 0.05f;
+
+// Contact ids, stable while the same features touch: bit 31 is set when B holds the reference
+// face. An incident vertex i is 0x10000 | i; a point where reference side plane j cut the
+// segment leaving incident vertex e is 0x20000 | j << 8 | e, where e is 0x80 | k for a segment
+// already running along side plane k.
+struct ContactPoint {
+    // halfway between the two surfaces
+    glm::vec3 position;
+    float depth;
+    uint32_t id;
+    // accumulated by the solver, carried over from the previous frame by ManifoldCache
+    float normalImpulse = 0.0f;
+};
+
+struct ContactManifold {
+    // from A to B, as the EPA normal
+    glm::vec3 normal = glm::vec3(0.0f);
+    ContactPoint points[MaxManifoldPoints];
+    int count = 0;
+};
+
+//------------------------------------------------------------------------------------------//
+// Features
+//------------------------------------------------------------------------------------------//
+
+int WorldSupportFeature(const ColliderView& collider, const glm::vec3& direction, glm::vec3* points) {
+
+    const ColliderTransform& transform = collider.transform;
+    int count = collider.shape->LocalSupportFeature(glm::transpose(transform.rotation) * direction, transform.scale, points);
+    for (int i = 0; i < count; i++) points[i] = transform.ToWorldPoint(points[i]);
+    return count;
+}
+
+// Newell's normal, turned to face the direction the feature was queried with
+glm::vec3 FeatureNormal(const glm::vec3* points, int count, const glm::vec3& direction) {
+
+    glm::vec3 normal = glm::vec3(0.0f);
+    for (int i = 0; i < count; i++) {
+        const glm::vec3& p = points[i];
+        const glm::vec3& q = points[(i + 1) % count];
+        normal += glm::vec3((p.y - q.y) * (p.z + q.z), (p.z - q.z) * (p.x + q.x), (p.x - q.x) * (p.y + q.y));
+    }
+
+    float len = glm::length(normal);
+    if (len < 1e-12f) return direction;
+
+    normal /= len;
+    return glm::dot(normal, direction) < 0.0f ? -normal : normal;
+}
+
+// closest points between segments p1-q1 and p2-q2 (Ericson 5.1.9)
+void ClosestBetweenSegments(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2, glm::vec3& c1, glm::vec3& c2) {
+
+    glm::vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+    float a = glm::dot(d1, d1), e = glm::dot(d2, d2), f = glm::dot(d2, r);
+    float s = 0.0f, t = 0.0f;
+
+    if (a <= 1e-12f && e <= 1e-12f) {
+        c1 = p1;
+        c2 = p2;
+        return;
+    }
+    if (a <= 1e-12f) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    }
+    else {
+        float c = glm::dot(d1, r);
+        if (e <= 1e-12f) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        }
+        else {
+            float b = glm::dot(d1, d2);
+            float denom = a * e - b * b;
+            if (denom > 1e-12f) s = std::clamp((b * f - c * e) / denom, 0.0f, 1.0f);
+
+            t = (b * s + f) / e;
+            if (t < 0.0f)      { t = 0.0f; s = std::clamp(-c / a, 0.0f, 1.0f); }
+            else if (t > 1.0f) { t = 1.0f; s = std::clamp((b - c) / a, 0.0f, 1.0f); }
+        }
+    }
+
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+}
+
+//------------------------------------------------------------------------------------------//
+// Clipping
+//------------------------------------------------------------------------------------------//
+
+struct ClipVertex {
+    glm::vec3 point;
+    uint32_t id;
+    // the segment from this vertex to the next one lies on this incident edge or side plane
+    uint32_t edge;
+};
+
+// Sutherland–Hodgman against one plane, keeping dot(normal, p) <= offset. A two point input is
+// clipped as a segment rather than as a closed polygon.
+int ClipAgainstPlane(const ClipVertex* in, int count, ClipVertex* out, const glm::vec3& normal, float offset, uint32_t plane) {
+
+    int outCount = 0;
+    int edges = count > 2 ? count : count - 1;
+
+    for (int i = 0; i < edges; i++) {
+        const ClipVertex& p = in[i];
+        const ClipVertex& q = in[(i + 1) % count];
+        float dp = glm::dot(normal, p.point) - offset;
+        float dq = glm::dot(normal, q.point) - offset;
+
+        if (dp <= 0.0f) out[outCount++] = p;
+        if ((dp <= 0.0f) != (dq <= 0.0f)) {
+            ClipVertex cut;
+            cut.point = p.point + (q.point - p.point) * (dp / (dp - dq));
+            cut.id = 0x20000u | (plane << 8) | (p.edge & 0xffu);
+            // leaving the face the rest of the segment is cut away, so the next segment runs along the plane
+            cut.edge = dp <= 0.0f ? 0x80u | plane : p.edge;
+            out[outCount++] = cut;
+        }
+    }
+    if (count == 2 && glm::dot(normal, in[1].point) - offset <= 0.0f) out[outCount++] = in[1];
+    if (count == 1 && glm::dot(normal, in[0].point) - offset <= 0.0f) out[outCount++] = in[0];
+
+    return outCount;
+}
+
+// Keeps the deepest point, the point furthest from it, the point spanning the largest triangle
+// with both and the point adding the most area on the other side of their edge.
+int ReduceContacts(const ContactPoint* in, int count, const glm::vec3& normal, ContactPoint* out) {
+
+    if (count <= MaxManifoldPoints) {
+        std::copy(in, in + count, out);
+        return count;
+    }
+
+    int first = 0;
+    for (int i = 1; i < count; i++) {
+        if (in[i].depth > in[first].depth) first = i;
+    }
+
+    int second = -1;
+    float best = -1.0f;
+    for (int i = 0; i < count; i++) {
+        glm::vec3 d = in[i].position - in[first].position;
+        if (i != first && glm::dot(d, d) > best) { best = glm::dot(d, d); second = i; }
+    }
+
+    glm::vec3 edge = in[second].position - in[first].position;
+    auto signedArea = [&](int i) { return glm::dot(glm::cross(edge, in[i].position - in[first].position), normal); };
+
+    int third = -1;
+    best = -1.0f;
+    for (int i = 0; i < count; i++) {
+        if (i != first && i != second && std::abs(signedArea(i)) > best) { best = std::abs(signedArea(i)); third = i; }
+    }
+
+    float side = signedArea(third) >= 0.0f ? -1.0f : 1.0f;
+    int fourth = -1;
+    best = 0.0f;
+    for (int i = 0; i < count; i++) {
+        if (i != first && i != second && i != third && side * signedArea(i) > best) { best = side * signedArea(i); fourth = i; }
+    }
+
+    out[0] = in[first];
+    out[1] = in[second];
+    out[2] = in[third];
+    if (fourth < 0) return 3;
+
+    out[3] = in[fourth];
+    return 4;
+}
+
+//------------------------------------------------------------------------------------------//
+// Build
+//------------------------------------------------------------------------------------------//
+
+// single contact halfway between the deepest point of one feature and the other surface
+void SinglePointManifold(const glm::vec3& point, const glm::vec3& offset, float depth, ContactManifold& manifold) {
+    manifold.points[0] = ContactPoint{point + offset, depth, 0};
+    manifold.count = 1;
+}
+
+// Turns an EPA result into up to four contacts. Both features facing the normal are queried;
+// the face better aligned with the normal is the reference and the other feature is clipped
+// against its side planes, keeping the points below it. A vertex or two crossing edges give a
+// single contact.
+bool BuildContactManifold(const ColliderView& colliderA, const ColliderView& colliderB, const collision& contact, ContactManifold& manifold) {
+
+    manifold.count = 0;
+    if (!contact.collided || glm::dot(contact.normal, contact.normal) < 1e-12f) return false;
+
+    glm::vec3 normal = glm::normalize(contact.normal);
+    manifold.normal = normal;
+
+    glm::vec3 featureA[MaxFeaturePoints], featureB[MaxFeaturePoints];
+    int countA = WorldSupportFeature(colliderA, normal, featureA);
+    int countB = WorldSupportFeature(colliderB, -normal, featureB);
+
+    if (countA == 1) {
+        SinglePointManifold(featureA[0], -normal * (contact.depth * 0.5f), contact.depth, manifold);
+        return true;
+    }
+    if (countB == 1) {
+        SinglePointManifold(featureB[0], normal * (contact.depth * 0.5f), contact.depth, manifold);
+        return true;
+    }
+    if (countA == 2 && countB == 2) {
+        glm::vec3 onA, onB;
+        ClosestBetweenSegments(featureA[0], featureA[1], featureB[0], featureB[1], onA, onB);
+        SinglePointManifold((onA + onB) * 0.5f, glm::vec3(0.0f), contact.depth, manifold);
+        return true;
+    }
+
+    glm::vec3 normalA = FeatureNormal(featureA, countA, normal);
+    glm::vec3 normalB = FeatureNormal(featureB, countB, -normal);
+
+    // A is preferred on near ties so resting contacts do not swap reference faces between frames
+    bool flip = countA < 3 || (countB >= 3 && glm::dot(normalB, -normal) > glm::dot(normalA, normal) + 0.001f);
+
+    const glm::vec3* reference = flip ? featureB : featureA;
+    const glm::vec3* incident  = flip ? featureA : featureB;
+    int referenceCount = flip ? countB : countA;
+    int incidentCount  = flip ? countA : countB;
+    glm::vec3 referenceNormal = flip ? normalB : normalA;
+
+    ClipVertex buffers[2][MaxFeaturePoints * 2 + 2];
+    for (int i = 0; i < incidentCount; i++) buffers[0][i] = ClipVertex{incident[i], 0x10000u | uint32_t(i), uint32_t(i)};
+
+    glm::vec3 centroid = glm::vec3(0.0f);
+    for (int i = 0; i < referenceCount; i++) centroid += reference[i];
+    centroid /= float(referenceCount);
+
+    int count = incidentCount, current = 0;
+    for (int j = 0; j < referenceCount && count > 0; j++) {
+        glm::vec3 edge = reference[(j + 1) % referenceCount] - reference[j];
+        glm::vec3 sideNormal = glm::cross(edge, referenceNormal);
+        if (glm::dot(sideNormal, sideNormal) < 1e-12f) continue;
+
+        sideNormal = glm::normalize(sideNormal);
+        if (glm::dot(sideNormal, reference[j] - centroid) < 0.0f) sideNormal = -sideNormal;
+
+        count = ClipAgainstPlane(buffers[current], count, buffers[1 - current], sideNormal, glm::dot(sideNormal, reference[j]), uint32_t(j));
+        current = 1 - current;
+    }
+
+    ContactPoint candidates[MaxFeaturePoints * 2 + 2];
+    int candidateCount = 0;
+    float referenceOffset = glm::dot(referenceNormal, reference[0]);
+
+    for (int i = 0; i < count; i++) {
+        const ClipVertex& vertex = buffers[current][i];
+        float depth = referenceOffset - glm::dot(referenceNormal, vertex.point);
+        if (depth < -ContactTolerance) continue;
+
+        glm::vec3 position = vertex.point + referenceNormal * (depth * 0.5f);
+        candidates[candidateCount++] = ContactPoint{position, depth, vertex.id | (flip ? 0x80000000u : 0u)};
+    }
+
+    // everything was clipped away, keep the incident point reaching furthest past the reference face
+    if (candidateCount == 0) {
+        int deepest = 0;
+        for (int i = 1; i < incidentCount; i++) {
+            if (glm::dot(referenceNormal, incident[i]) < glm::dot(referenceNormal, incident[deepest])) deepest = i;
+        }
+        uint32_t id = (0x10000u | uint32_t(deepest)) | (flip ? 0x80000000u : 0u);
+        manifold.points[0] = ContactPoint{incident[deepest] + referenceNormal * (contact.depth * 0.5f), contact.depth, id};
+        manifold.count = 1;
+        return true;
+    }
+
+    manifold.count = ReduceContacts(candidates, candidateCount, normal, manifold.points);
+    return true;
+}
+
+bool BuildContactManifold(RObject* a, RObject* b, ContactManifold& manifold) {
+
+    ColliderView colliderA = a->GetCollider();
+    ColliderView colliderB = b->GetCollider();
+    return BuildContactManifold(colliderA, colliderB, GJKCollision(colliderA, colliderB), manifold);
+}
+
+//------------------------------------------------------------------------------------------//
+// Manifold cache
+//------------------------------------------------------------------------------------------//
+
+struct ManifoldCacheStats {
+    uint64_t contacts = 0, matched = 0;
+
+    float MatchRate() const { return contacts ? float(matched) / float(contacts) : 0.0f; }
+};
+
+// Keeps last frame's manifold of every (a, b) pair so the solver can warm start: a new contact
+// takes the impulse of the old contact with the same id, or of the nearest old contact if the
+// features changed but the point barely moved. Pairs are ordered like in GJKPairCache.
+class ManifoldCache {
+public:
+    ManifoldCacheStats stats;
+
+    // fills in the impulses of manifold from the pair's previous manifold, then stores it
+    void Update(const CollisionPair& pair, ContactManifold& manifold);
+    // the manifold stored for the pair this frame, or nullptr
+    ContactManifold* Find(const CollisionPair& pair);
+    // drops the pairs that were not updated during the frame that just ended
+    void NextFrame();
+    void ResetStats() { stats = ManifoldCacheStats{}; }
+    size_t Size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        ContactManifold manifold;
+        uint64_t frame = 0;
+    };
+
+    std::unordered_map<CollisionPair, Entry, CollisionPairHash, CollisionPairEqual> entries;
+    uint64_t frame = 1;
+};
+
+void ManifoldCache::Update(const CollisionPair& pair, ContactManifold& manifold) {
+
+    auto [it, inserted] = entries.try_emplace(pair);
+    Entry& entry = it->second;
+    stats.contacts += manifold.count;
+
+    // impulses along a normal that turned away no longer apply
+    const ContactManifold& old = entry.manifold;
+    bool usable = !inserted && glm::dot(old.normal, manifold.normal) > 0.95f;
+
+    bool taken[MaxManifoldPoints] = {};
+    for (int i = 0; usable && i < manifold.count; i++) {
+        ContactPoint& point = manifold.points[i];
+
+        int match = -1;
+        for (int j = 0; j < old.count; j++) {
+            if (!taken[j] && old.points[j].id == point.id) { match = j; break; }
+        }
+        if (match < 0) {
+            float best = ContactMatchDistance * ContactMatchDistance;
+            for (int j = 0; j < old.count; j++) {
+                glm::vec3 d = old.points[j].position - point.position;
+                if (!taken[j] && glm::dot(d, d) <= best) { best = glm::dot(d, d); match = j; }
+            }
+        }
+        if (match < 0) continue;
+
+        taken[match] = true;
+        point.normalImpulse = old.points[match].normalImpulse;
+        stats.matched++;
+    }
+
+    entry.manifold = manifold;
+    entry.frame = frame;
+}
+
+ContactManifold* ManifoldCache::Find(const CollisionPair& pair) {
+
+    auto it = entries.find(pair);
+    if (it == entries.end() || it->second.frame != frame) return nullptr;
+    return &it->second.manifold;
+}
+
+void ManifoldCache::NextFrame() {
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.frame != frame) it = entries.erase(it);
+        else it++;
+    }
+    frame++;
+}
+
+}
+
+#endif /* manifold_h */
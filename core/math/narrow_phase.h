@@ -0,0 +1,124 @@
+//
+//  narrow_phase.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-16.
+//
+
+#ifndef narrow_phase_h
+#define narrow_phase_h
+
+namespace core {
+
+struct PairContact {
+    uint32_t pair;
+    collision contact;
+};
+
+//------------------------------------------------------------------------------------------//
+// Batched GJK
+//------------------------------------------------------------------------------------------//
+
+// Collides colliders[i * 2] against colliders[i * 2 + 1] into out[i], every slot is written.
+// When directions is not empty, directions[i] seeds pair i and is left holding its last search
+// direction, as in GJKPairCache. Only reads the views, so disjoint chunks can run in parallel.
+// Returns the support pairs used over the whole batch.
+uint64_t GJKCollideBatch(std::span<const ColliderView> colliders, std::span<glm::vec3> directions, std::span<collision> out) {
+    
+    uint64_t total = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+        glm::vec3 direction = directions.empty() ? glm::vec3(1.0f, 0.0f, 0.0f) : directions[i];
+        int iterations = 0;
+        out[i] = CollideShapes(colliders[i * 2], colliders[i * 2 + 1], direction, iterations);
+        if (!directions.empty()) directions[i] = direction;
+        total += iterations;
+    }
+    return total;
+}
+
+// Collides pairs[i] into out[i]. Every collider is staged into one contiguous array first, so
+// transforms are refreshed up front and the loop no longer chases RObject pointers.
+void GJKCollideBatch(std::span<const CollisionPair> pairs, std::span<collision> out) {
+    
+    static thread_local std::vector<ColliderView> staged;
+    
+    size_t count = std::min(pairs.size(), out.size());
+    staged.resize(count * 2);
+    
+    for (size_t i = 0; i < count; i++) {
+        staged[i * 2]     = pairs[i].a->GetCollider();
+        staged[i * 2 + 1] = pairs[i].b->GetCollider();
+    }
+    GJKCollideBatch(staged, {}, out.first(count));
+}
+
+//------------------------------------------------------------------------------------------//
+// Parallel narrow phase
+//------------------------------------------------------------------------------------------//
+
+// Splits a pair list across the job pool, one GJKCollideBatch per chunk. Colliders are staged
+// serially first, since reading an RObject's collider refreshes its caches; the chunks then only
+// read staged views. Every pair gets its own result slot, so the contact list comes out in pair
+// order no matter how the chunks were scheduled.
+// With a pair cache, the seed directions are read from it while staging and written back after
+// the batch, so a pair list must not contain the same pair twice.
+class ParallelNarrowPhase {
+public:
+    JobPool& pool;
+    size_t grainSize;
+    GJKPairCache* cache;
+    
+    ParallelNarrowPhase(JobPool& pool, size_t grainSize = 64, GJKPairCache* cache = nullptr) : pool(pool), grainSize(grainSize), cache(cache) {}
+    
+    void Collide(std::span<const CollisionPair> pairs, std::vector<PairContact>& contacts);
+    
+private:
+    std::vector<ColliderView> staged;
+    std::vector<GJKCacheEntry*> stagedEntries;
+    std::vector<glm::vec3> directions;
+    std::vector<collision> results;
+    std::vector<uint64_t> slotIterations;
+};
+
+void ParallelNarrowPhase::Collide(std::span<const CollisionPair> pairs, std::vector<PairContact>& contacts) {
+    
+    staged.resize(pairs.size() * 2);
+    for (size_t i = 0; i < pairs.size(); i++) {
+        staged[i * 2]     = pairs[i].a->GetCollider();
+        staged[i * 2 + 1] = pairs[i].b->GetCollider();
+    }
+    
+    directions.assign(pairs.size(), glm::vec3(1.0f, 0.0f, 0.0f));
+    stagedEntries.assign(pairs.size(), nullptr);
+    if (cache) {
+        bool hit;
+        for (size_t i = 0; i < pairs.size(); i++) {
+            stagedEntries[i] = &cache->Find(pairs[i], hit);
+            directions[i] = stagedEntries[i]->direction;
+        }
+    }
+    
+    results.resize(pairs.size());
+    slotIterations.assign(pool.SlotCount(), 0);
+    
+    pool.ParallelFor(pairs.size(), grainSize, [this](size_t begin, size_t end, unsigned slot) {
+        std::span<const ColliderView> colliders(staged.data() + begin * 2, (end - begin) * 2);
+        std::span<glm::vec3> seeds(directions.data() + begin, end - begin);
+        std::span<collision> out(results.data() + begin, end - begin);
+        slotIterations[slot] += GJKCollideBatch(colliders, seeds, out);
+    });
+    
+    if (cache) {
+        for (size_t i = 0; i < pairs.size(); i++) stagedEntries[i]->direction = directions[i];
+        for (uint64_t iterations : slotIterations) cache->stats.iterations += iterations;
+    }
+    
+    contacts.clear();
+    for (size_t i = 0; i < pairs.size(); i++) {
+        if (results[i].collided) contacts.push_back(PairContact{(uint32_t)i, results[i]});
+    }
+}
+
+}
+
+#endif /* narrow_phase_h */
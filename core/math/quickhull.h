@@ -0,0 +1,244 @@
+//
+//  quickhull.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-15.
+//
+
+#ifndef quickhull_h
+#define quickhull_h
+
+#include <unordered_map>
+
+namespace core {
+
+// Convex hull of a point cloud with its vertex adjacency in CSR form: the neighbours of
+// vertex i are adjacency[adjacencyOffsets[i] .. adjacencyOffsets[i + 1])
+struct ConvexHull {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> faces;
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+};
+
+//------------------------------------------------------------------------------------------//
+// Helper
+//------------------------------------------------------------------------------------------//
+
+struct QuickHullFace {
+    uint32_t v[3];
+    glm::vec3 normal;
+    float offset;
+    std::vector<uint32_t> outside;
+    bool alive;
+};
+
+inline uint64_t QuickHullEdgeKey(uint32_t a, uint32_t b) {
+    return (uint64_t(a) << 32) | b;
+}
+
+// every vertex is connected to every other one, hill climbing then takes a single step
+void BuildCompleteAdjacency(ConvexHull& hull) {
+
+    uint32_t count = (uint32_t)hull.vertices.size();
+    hull.adjacencyOffsets.assign(1, 0);
+    hull.adjacency.clear();
+
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = 0; j < count; j++) {
+            if (i != j) hull.adjacency.push_back(j);
+        }
+        hull.adjacencyOffsets.push_back((uint32_t)hull.adjacency.size());
+    }
+}
+
+//------------------------------------------------------------------------------------------//
+// QuickHull
+//------------------------------------------------------------------------------------------//
+
+ConvexHull QuickHull(std::span<const glm::vec3> points, float epsilon = 1e-5f) {
+
+    ConvexHull hull;
+    if (points.empty()) return hull;
+
+    float extent = 0.0f;
+    for (const glm::vec3& p : points) extent = std::max({extent, std::abs(p.x), std::abs(p.y), std::abs(p.z)});
+    float eps = epsilon * std::max(extent, 1.0f);
+
+    auto degenerate = [&]() {
+        hull.vertices.assign(points.begin(), points.end());
+        hull.faces.clear();
+        BuildCompleteAdjacency(hull);
+        return hull;
+    };
+    if (points.size() < 4) return degenerate();
+
+    // initial tetrahedron from the extreme points
+    uint32_t extremes[6] = {0, 0, 0, 0, 0, 0};
+    for (uint32_t i = 0; i < points.size(); i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            if (points[i][axis] < points[extremes[axis * 2]][axis])     extremes[axis * 2]     = i;
+            if (points[i][axis] > points[extremes[axis * 2 + 1]][axis]) extremes[axis * 2 + 1] = i;
+        }
+    }
+
+    uint32_t i0 = 0, i1 = 0;
+    float maxDistance = -1.0f;
+    for (int i = 0; i < 6; i++) {
+        for (int j = i + 1; j < 6; j++) {
+            float d = glm::length2(points[extremes[i]] - points[extremes[j]]);
+            if (d > maxDistance) { maxDistance = d; i0 = extremes[i]; i1 = extremes[j]; }
+        }
+    }
+    if (maxDistance < eps * eps) return degenerate();
+
+    uint32_t i2 = 0;
+    maxDistance = -1.0f;
+    glm::vec3 line = glm::normalize(points[i1] - points[i0]);
+    for (uint32_t i = 0; i < points.size(); i++) {
+        float d = glm::length2(glm::cross(points[i] - points[i0], line));
+        if (d > maxDistance) { maxDistance = d; i2 = i; }
+    }
+    if (maxDistance < eps * eps) return degenerate();
+
+    uint32_t i3 = 0;
+    maxDistance = -1.0f;
+    glm::vec3 planeNormal = glm::normalize(glm::cross(points[i1] - points[i0], points[i2] - points[i0]));
+    for (uint32_t i = 0; i < points.size(); i++) {
+        float d = std::abs(glm::dot(points[i] - points[i0], planeNormal));
+        if (d > maxDistance) { maxDistance = d; i3 = i; }
+    }
+    if (maxDistance < eps) return degenerate();
+
+    std::vector<QuickHullFace> faces;
+    std::unordered_map<uint64_t, uint32_t> edgeFace;
+    glm::vec3 centroid = (points[i0] + points[i1] + points[i2] + points[i3]) * 0.25f;
+
+    auto addFace = [&](uint32_t a, uint32_t b, uint32_t c) {
+        QuickHullFace face{};
+        face.v[0] = a; face.v[1] = b; face.v[2] = c;
+        face.normal = glm::cross(points[b] - points[a], points[c] - points[a]);
+        float len = glm::length(face.normal);
+        face.normal = len > 0.0f ? face.normal / len : glm::vec3(0.0f);
+        face.offset = glm::dot(face.normal, points[a]);
+        face.alive = true;
+
+        uint32_t index = (uint32_t)faces.size();
+        edgeFace[QuickHullEdgeKey(a, b)] = index;
+        edgeFace[QuickHullEdgeKey(b, c)] = index;
+        edgeFace[QuickHullEdgeKey(c, a)] = index;
+        faces.push_back(std::move(face));
+        return index;
+    };
+    auto addOutwardFace = [&](uint32_t a, uint32_t b, uint32_t c) {
+        glm::vec3 n = glm::cross(points[b] - points[a], points[c] - points[a]);
+        if (glm::dot(n, centroid - points[a]) > 0.0f) std::swap(b, c);
+        addFace(a, b, c);
+    };
+
+    addOutwardFace(i0, i1, i2);
+    addOutwardFace(i0, i1, i3);
+    addOutwardFace(i0, i2, i3);
+    addOutwardFace(i1, i2, i3);
+
+    auto assign = [&](uint32_t point, const std::vector<uint32_t>& candidates) {
+        for (uint32_t f : candidates) {
+            QuickHullFace& face = faces[f];
+            if (glm::dot(face.normal, points[point]) - face.offset > eps) {
+                face.outside.push_back(point);
+                return;
+            }
+        }
+    };
+
+    std::vector<uint32_t> initialFaces = {0, 1, 2, 3};
+    for (uint32_t i = 0; i < points.size(); i++) {
+        if (i == i0 || i == i1 || i == i2 || i == i3) continue;
+        assign(i, initialFaces);
+    }
+
+    std::vector<uint32_t> visible, newFaces, orphans;
+    std::vector<std::pair<uint32_t, uint32_t>> horizon;
+
+    for (uint32_t f = 0; f < faces.size(); f++) {
+
+        if (!faces[f].alive || faces[f].outside.empty()) continue;
+
+        // farthest outside point of this face becomes the eye
+        uint32_t eye = faces[f].outside[0];
+        float eyeDistance = -FLT_MAX;
+        for (uint32_t point : faces[f].outside) {
+            float d = glm::dot(faces[f].normal, points[point]) - faces[f].offset;
+            if (d > eyeDistance) { eyeDistance = d; eye = point; }
+        }
+
+        visible.clear();
+        for (uint32_t g = 0; g < faces.size(); g++) {
+            if (faces[g].alive && glm::dot(faces[g].normal, points[eye]) - faces[g].offset > eps) visible.push_back(g);
+        }
+        for (uint32_t g : visible) faces[g].alive = false;
+
+        horizon.clear();
+        orphans.clear();
+        for (uint32_t g : visible) {
+            const QuickHullFace& face = faces[g];
+            for (int e = 0; e < 3; e++) {
+                uint32_t a = face.v[e], b = face.v[(e + 1) % 3];
+                auto twin = edgeFace.find(QuickHullEdgeKey(b, a));
+                if (twin != edgeFace.end() && faces[twin->second].alive) horizon.emplace_back(a, b);
+            }
+            for (uint32_t point : face.outside) if (point != eye) orphans.push_back(point);
+        }
+        for (uint32_t g : visible) {
+            const QuickHullFace& face = faces[g];
+            for (int e = 0; e < 3; e++) {
+                auto edge = edgeFace.find(QuickHullEdgeKey(face.v[e], face.v[(e + 1) % 3]));
+                if (edge != edgeFace.end() && edge->second == g) edgeFace.erase(edge);
+            }
+            faces[g].outside.clear();
+            faces[g].outside.shrink_to_fit();
+        }
+
+        newFaces.clear();
+        for (auto [a, b] : horizon) newFaces.push_back(addFace(a, b, eye));
+        // new faces are appended, so the forward scan reaches them later
+        for (uint32_t point : orphans) assign(point, newFaces);
+    }
+
+    // compact the vertices referenced by the surviving faces
+    std::vector<uint32_t> remap(points.size(), UINT32_MAX);
+    for (const QuickHullFace& face : faces) {
+        if (!face.alive) continue;
+        for (int e = 0; e < 3; e++) {
+            uint32_t v = face.v[e];
+            if (remap[v] == UINT32_MAX) {
+                remap[v] = (uint32_t)hull.vertices.size();
+                hull.vertices.push_back(points[v]);
+            }
+            hull.faces.push_back(remap[v]);
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> neighbours(hull.vertices.size());
+    for (size_t i = 0; i < hull.faces.size(); i += 3) {
+        for (int e = 0; e < 3; e++) {
+            uint32_t a = hull.faces[i + e], b = hull.faces[i + (e + 1) % 3];
+            // every undirected edge is shared by two faces, record it once from each side
+            neighbours[a].push_back(b);
+        }
+    }
+
+    hull.adjacencyOffsets.assign(1, 0);
+    for (std::vector<uint32_t>& list : neighbours) {
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+        hull.adjacency.insert(hull.adjacency.end(), list.begin(), list.end());
+        hull.adjacencyOffsets.push_back((uint32_t)hull.adjacency.size());
+    }
+
+    return hull;
+}
+
+}
+
+#endif /* quickhull_h */
@@ -0,0 +1,476 @@
+//
+//  ray_packet.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-26.
+//
+
+#ifndef ray_packet_h
+#define ray_packet_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Ray packet
+//------------------------------------------------------------------------------------------//
+
+constexpr uint32_t RayPacketWidth = 8;
+
+// Up to RayPacketWidth rays in structure of arrays form, in the local space of the BVH they are
+// cast against. Lanes past count start with a negative tmax, so no box or triangle accepts them.
+struct alignas(32) RayPacket {
+    float ox[RayPacketWidth], oy[RayPacketWidth], oz[RayPacketWidth];
+    float dx[RayPacketWidth], dy[RayPacketWidth], dz[RayPacketWidth];
+    float ix[RayPacketWidth], iy[RayPacketWidth], iz[RayPacketWidth];
+    // closest hit so far and the triangle it was on, UINT32_MAX for none
+    float tmax[RayPacketWidth];
+    uint32_t triangle[RayPacketWidth];
+    // summed directions, picks which child the whole packet visits first
+    glm::vec3 direction;
+    uint32_t count;
+};
+
+// moves rays into the local space of `transform`, the ray parameter is kept as in Raycast
+void PackRays(std::span<const Ray> rays, const ColliderTransform& transform, RayPacket& packet) {
+
+    packet.count = (uint32_t)std::min<size_t>(rays.size(), RayPacketWidth);
+    packet.direction = glm::vec3(0.0f);
+
+    // no ray to pad the lanes with, every lane stays empty
+    if (rays.empty()) {
+        for (uint32_t i = 0; i < RayPacketWidth; i++) {
+            packet.ox[i] = packet.oy[i] = packet.oz[i] = 0.0f;
+            packet.dx[i] = packet.dy[i] = packet.dz[i] = 0.0f;
+            packet.ix[i] = packet.iy[i] = packet.iz[i] = FLT_MAX;
+            packet.tmax[i] = -1.0f;
+            packet.triangle[i] = UINT32_MAX;
+        }
+        return;
+    }
+
+    glm::mat3 inverseRotation = glm::transpose(transform.rotation);
+
+    for (uint32_t i = 0; i < RayPacketWidth; i++) {
+        const Ray& ray = rays[i < packet.count ? i : 0];
+        glm::vec3 origin = inverseRotation * (ray.origin - transform.translation) / transform.scale;
+        glm::vec3 direction = inverseRotation * ray.direction / transform.scale;
+
+        packet.ox[i] = origin.x;
+        packet.oy[i] = origin.y;
+        packet.oz[i] = origin.z;
+        packet.dx[i] = direction.x;
+        packet.dy[i] = direction.y;
+        packet.dz[i] = direction.z;
+        glm::vec3 inverse = RayInverseDirection(direction);
+        packet.ix[i] = inverse.x;
+        packet.iy[i] = inverse.y;
+        packet.iz[i] = inverse.z;
+        packet.tmax[i] = i < packet.count ? FLT_MAX : -1.0f;
+        packet.triangle[i] = UINT32_MAX;
+
+        if (i < packet.count) packet.direction += direction;
+    }
+}
+
+//------------------------------------------------------------------------------------------//
+// Lane kernels
+//------------------------------------------------------------------------------------------//
+
+// Each lane set tests every ray of the packet at once. NodeMask has a bit for every lane that
+// enters the box before its closest hit; IntersectTriangle is Möller–Trumbore and keeps the hit
+// in the lanes where it is closer.
+
+struct ScalarLanes {
+
+    static uint32_t NodeMask(const RayPacket& packet, const BVHNode& node) {
+
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < RayPacketWidth; i++) {
+            Ray ray = Ray{glm::vec3(packet.ox[i], packet.oy[i], packet.oz[i]), glm::vec3(packet.dx[i], packet.dy[i], packet.dz[i])};
+            glm::vec3 invDir = glm::vec3(packet.ix[i], packet.iy[i], packet.iz[i]);
+            if (packet.tmax[i] >= 0.0f && RayNodeDistance(ray, invDir, node, packet.tmax[i]) != FLT_MAX) mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    static void IntersectTriangle(RayPacket& packet, const Triangle& triangle, uint32_t index) {
+
+        for (uint32_t i = 0; i < RayPacketWidth; i++) {
+            Ray ray = Ray{glm::vec3(packet.ox[i], packet.oy[i], packet.oz[i]), glm::vec3(packet.dx[i], packet.dy[i], packet.dz[i])};
+            std::optional<float> t = RayIntersectTriangle(ray, triangle);
+            if (t && *t < packet.tmax[i]) {
+                packet.tmax[i] = *t;
+                packet.triangle[i] = index;
+            }
+        }
+    }
+};
+
+#if SUPPORT_X86_SIMD
+
+// two passes of four lanes
+struct SSE41Lanes {
+
+    __attribute__((target("sse4.1")))
+    static uint32_t NodeMask(const RayPacket& packet, const BVHNode& node) {
+
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < RayPacketWidth; i += 4) {
+            __m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min.x), _mm_load_ps(&packet.ox[i])), _mm_load_ps(&packet.ix[i]));
+            __m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min.y), _mm_load_ps(&packet.oy[i])), _mm_load_ps(&packet.iy[i]));
+            __m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.min.z), _mm_load_ps(&packet.oz[i])), _mm_load_ps(&packet.iz[i]));
+            __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max.x), _mm_load_ps(&packet.ox[i])), _mm_load_ps(&packet.ix[i]));
+            __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max.y), _mm_load_ps(&packet.oy[i])), _mm_load_ps(&packet.iy[i]));
+            __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.max.z), _mm_load_ps(&packet.oz[i])), _mm_load_ps(&packet.iz[i]));
+
+            __m128 tmin = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_max_ps(_mm_min_ps(t0z, t1z), _mm_setzero_ps()));
+            __m128 tmax = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_load_ps(&packet.tmax[i])));
+            mask |= (uint32_t)_mm_movemask_ps(_mm_cmpge_ps(tmax, tmin)) << i;
+        }
+        return mask;
+    }
+
+    __attribute__((target("sse4.1")))
+    static void IntersectTriangle(RayPacket& packet, const Triangle& triangle, uint32_t index) {
+
+        glm::vec3 edge1 = triangle.b - triangle.a;
+        glm::vec3 edge2 = triangle.c - triangle.a;
+        const __m128 e1x = _mm_set1_ps(edge1.x), e1y = _mm_set1_ps(edge1.y), e1z = _mm_set1_ps(edge1.z);
+        const __m128 e2x = _mm_set1_ps(edge2.x), e2y = _mm_set1_ps(edge2.y), e2z = _mm_set1_ps(edge2.z);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), epsilon = _mm_set1_ps(1e-7f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+        for (uint32_t i = 0; i < RayPacketWidth; i += 4) {
+            __m128 dx = _mm_load_ps(&packet.dx[i]), dy = _mm_load_ps(&packet.dy[i]), dz = _mm_load_ps(&packet.dz[i]);
+
+            __m128 hx = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 hy = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 hz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, hx), _mm_mul_ps(e1y, hy)), _mm_mul_ps(e1z, hz));
+            __m128 f = _mm_div_ps(one, a);
+
+            __m128 sx = _mm_sub_ps(_mm_load_ps(&packet.ox[i]), _mm_set1_ps(triangle.a.x));
+            __m128 sy = _mm_sub_ps(_mm_load_ps(&packet.oy[i]), _mm_set1_ps(triangle.a.y));
+            __m128 sz = _mm_sub_ps(_mm_load_ps(&packet.oz[i]), _mm_set1_ps(triangle.a.z));
+            __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, hx), _mm_mul_ps(sy, hy)), _mm_mul_ps(sz, hz)));
+
+            __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+            __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+
+            __m128 tmax = _mm_load_ps(&packet.tmax[i]);
+            __m128 hit = _mm_cmpge_ps(_mm_and_ps(a, absMask), epsilon);
+            hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+            hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)));
+            hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpgt_ps(t, epsilon), _mm_cmplt_ps(t, tmax)));
+            if (_mm_movemask_ps(hit) == 0) continue;
+
+            _mm_store_ps(&packet.tmax[i], _mm_blendv_ps(tmax, t, hit));
+            __m128i triangles = _mm_load_si128((const __m128i*)&packet.triangle[i]);
+            triangles = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(triangles), _mm_castsi128_ps(_mm_set1_epi32((int)index)), hit));
+            _mm_store_si128((__m128i*)&packet.triangle[i], triangles);
+        }
+    }
+};
+
+struct AVX2Lanes {
+
+    __attribute__((target("avx2")))
+    static uint32_t NodeMask(const RayPacket& packet, const BVHNode& node) {
+
+        __m256 t0x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.min.x), _mm256_load_ps(packet.ox)), _mm256_load_ps(packet.ix));
+        __m256 t0y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.min.y), _mm256_load_ps(packet.oy)), _mm256_load_ps(packet.iy));
+        __m256 t0z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.min.z), _mm256_load_ps(packet.oz)), _mm256_load_ps(packet.iz));
+        __m256 t1x = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.max.x), _mm256_load_ps(packet.ox)), _mm256_load_ps(packet.ix));
+        __m256 t1y = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.max.y), _mm256_load_ps(packet.oy)), _mm256_load_ps(packet.iy));
+        __m256 t1z = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.max.z), _mm256_load_ps(packet.oz)), _mm256_load_ps(packet.iz));
+
+        __m256 tmin = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(t0x, t1x), _mm256_min_ps(t0y, t1y)), _mm256_max_ps(_mm256_min_ps(t0z, t1z), _mm256_setzero_ps()));
+        __m256 tmax = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(t0x, t1x), _mm256_max_ps(t0y, t1y)), _mm256_min_ps(_mm256_max_ps(t0z, t1z), _mm256_load_ps(packet.tmax)));
+        return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(tmax, tmin, _CMP_GE_OQ));
+    }
+
+    __attribute__((target("avx2")))
+    static void IntersectTriangle(RayPacket& packet, const Triangle& triangle, uint32_t index) {
+
+        glm::vec3 edge1 = triangle.b - triangle.a;
+        glm::vec3 edge2 = triangle.c - triangle.a;
+        const __m256 e1x = _mm256_set1_ps(edge1.x), e1y = _mm256_set1_ps(edge1.y), e1z = _mm256_set1_ps(edge1.z);
+        const __m256 e2x = _mm256_set1_ps(edge2.x), e2y = _mm256_set1_ps(edge2.y), e2z = _mm256_set1_ps(edge2.z);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), epsilon = _mm256_set1_ps(1e-7f);
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+        __m256 dx = _mm256_load_ps(packet.dx), dy = _mm256_load_ps(packet.dy), dz = _mm256_load_ps(packet.dz);
+
+        __m256 hx = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+        __m256 hy = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+        __m256 hz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+        __m256 a = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, hx), _mm256_mul_ps(e1y, hy)), _mm256_mul_ps(e1z, hz));
+        __m256 f = _mm256_div_ps(one, a);
+
+        __m256 sx = _mm256_sub_ps(_mm256_load_ps(packet.ox), _mm256_set1_ps(triangle.a.x));
+        __m256 sy = _mm256_sub_ps(_mm256_load_ps(packet.oy), _mm256_set1_ps(triangle.a.y));
+        __m256 sz = _mm256_sub_ps(_mm256_load_ps(packet.oz), _mm256_set1_ps(triangle.a.z));
+        __m256 u = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, hx), _mm256_mul_ps(sy, hy)), _mm256_mul_ps(sz, hz)));
+
+        __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+        __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+        __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+        __m256 v = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)));
+        __m256 t = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)));
+
+        __m256 tmax = _mm256_load_ps(packet.tmax);
+        __m256 hit = _mm256_cmp_ps(_mm256_and_ps(a, absMask), epsilon, _CMP_GE_OQ);
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(u, one, _CMP_LE_OQ)));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(v, zero, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ)));
+        hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(t, epsilon, _CMP_GT_OQ), _mm256_cmp_ps(t, tmax, _CMP_LT_OQ)));
+        if (_mm256_movemask_ps(hit) == 0) return;
+
+        _mm256_store_ps(packet.tmax, _mm256_blendv_ps(tmax, t, hit));
+        __m256i triangles = _mm256_load_si256((const __m256i*)packet.triangle);
+        triangles = _mm256_blendv_epi8(triangles, _mm256_set1_epi32((int)index), _mm256_castps_si256(hit));
+        _mm256_store_si256((__m256i*)packet.triangle, triangles);
+    }
+};
+
+#endif
+
+//------------------------------------------------------------------------------------------//
+// Packet traversal
+//------------------------------------------------------------------------------------------//
+
+// One stack walk for the whole packet. A node is entered when any lane hits its box and dropped
+// for all lanes at once when none does; popped nodes are tested again against the hits found
+// since they were pushed.
+template<typename Lanes>
+inline void TraversePacketLanes(const TriangleBVH& bvh, RayPacket& packet) {
+
+    if (bvh.nodes.empty() || Lanes::NodeMask(packet, bvh.nodes[0]) == 0) return;
+
+    uint32_t stack[BVHStackSize];
+    int size = 0;
+    uint32_t index = 0;
+
+    while (true) {
+        const BVHNode& node = bvh.nodes[index];
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) Lanes::IntersectTriangle(packet, bvh.triangles[i], i);
+        }
+        else {
+            uint32_t nearChild = node.first, farChild = node.first + 1;
+            const BVHNode& left = bvh.nodes[nearChild];
+            const BVHNode& right = bvh.nodes[farChild];
+            if (glm::dot((left.min + left.max) - (right.min + right.max), packet.direction) > 0.0f) std::swap(nearChild, farChild);
+
+            bool nearHit = Lanes::NodeMask(packet, bvh.nodes[nearChild]) != 0;
+            bool farHit  = Lanes::NodeMask(packet, bvh.nodes[farChild]) != 0;
+
+            if (nearHit || farHit) {
+                if (nearHit && farHit) stack[size++] = farChild;
+                index = nearHit ? nearChild : farChild;
+                continue;
+            }
+        }
+
+        index = UINT32_MAX;
+        while (size > 0) {
+            uint32_t candidate = stack[--size];
+            if (Lanes::NodeMask(packet, bvh.nodes[candidate]) != 0) {
+                index = candidate;
+                break;
+            }
+        }
+        if (index == UINT32_MAX) break;
+    }
+}
+
+void TraversePacketScalar(const TriangleBVH& bvh, RayPacket& packet) {
+    TraversePacketLanes<ScalarLanes>(bvh, packet);
+}
+
+#if SUPPORT_X86_SIMD
+
+// flatten pulls the traversal and the lane kernels into one function compiled for the target
+__attribute__((target("sse4.1"), flatten))
+void TraversePacketSSE41(const TriangleBVH& bvh, RayPacket& packet) {
+    TraversePacketLanes<SSE41Lanes>(bvh, packet);
+}
+
+__attribute__((target("avx2"), flatten))
+void TraversePacketAVX2(const TriangleBVH& bvh, RayPacket& packet) {
+    TraversePacketLanes<AVX2Lanes>(bvh, packet);
+}
+
+#endif
+
+//------------------------------------------------------------------------------------------//
+// Dispatch
+//------------------------------------------------------------------------------------------//
+
+using RayPacketKernel = void (*)(const TriangleBVH&, RayPacket&);
+
+RayPacketKernel SelectRayPacketKernel() {
+#if SUPPORT_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))   return TraversePacketAVX2;
+    if (__builtin_cpu_supports("sse4.1")) return TraversePacketSSE41;
+#endif
+    return TraversePacketScalar;
+}
+
+void TraversePacket(const TriangleBVH& bvh, RayPacket& packet) {
+    static const RayPacketKernel kernel = SelectRayPacketKernel();
+    kernel(bvh, packet);
+}
+
+//------------------------------------------------------------------------------------------//
+// Kernel check
+//------------------------------------------------------------------------------------------//
+
+struct RayPacketCheck {
+    uint32_t rays = 0, hits = 0, mismatches = 0;
+};
+
+// Casts rays through every lane kernel the CPU runs and compares each lane with
+// TriangleBVH::ClosestTriangle for the same ray. The triangle and the distance must be identical,
+// except that another triangle hit at exactly the same distance (a ray through a shared edge)
+// counts as the same hit. Rays lying in slab planes with zero direction components are where the
+// kernels' min/max are most likely to drift apart, so most of the rays are axis aligned grids
+// lined up with the mesh's faces and the node boxes, plus a fan from outside the mesh.
+RayPacketCheck CheckRayPacketKernels(const TriangleBVH& bvh, uint32_t resolution = 16) {
+
+    RayPacketCheck check;
+    if (bvh.Empty() || resolution < 2) return check;
+
+    std::vector<RayPacketKernel> kernels = {TraversePacketScalar};
+#if SUPPORT_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) kernels.push_back(TraversePacketSSE41);
+    if (__builtin_cpu_supports("avx2"))   kernels.push_back(TraversePacketAVX2);
+#endif
+
+    glm::vec3 min = glm::vec3(FLT_MAX), max = glm::vec3(-FLT_MAX);
+    for (const Triangle& triangle : bvh.triangles) {
+        min = glm::min(min, triangle.minBound);
+        max = glm::max(max, triangle.maxBound);
+    }
+    glm::vec3 extent = max - min;
+    float margin = glm::length(extent) + 1.0f;
+
+    // the last step lands on max exactly rather than near it
+    auto gridPoint = [&](int axis, uint32_t i) {
+        return i + 1 == resolution ? max[axis] : min[axis] + extent[axis] * float(i) / float(resolution - 1);
+    };
+
+    std::vector<Ray> rays;
+    for (int axis = 0; axis < 3; axis++) {
+        int u = (axis + 1) % 3, w = (axis + 2) % 3;
+        for (float sign : {-1.0f, 1.0f}) {
+            for (uint32_t i = 0; i < resolution; i++) {
+                for (uint32_t j = 0; j < resolution; j++) {
+                    glm::vec3 origin, direction = glm::vec3(0.0f);
+                    origin[axis] = sign > 0.0f ? min[axis] - margin : max[axis] + margin;
+                    origin[u] = gridPoint(u, i);
+                    origin[w] = gridPoint(w, j);
+                    direction[axis] = sign;
+                    rays.push_back(Ray{origin, direction});
+                }
+            }
+        }
+    }
+    for (const BVHNode& node : bvh.nodes) {
+        for (int axis = 0; axis < 3; axis++) {
+            int u = (axis + 1) % 3;
+            glm::vec3 origin = (node.min + node.max) * 0.5f, direction = glm::vec3(0.0f);
+            origin[axis] = node.max[axis];
+            origin[u] = min[u] - margin;
+            direction[u] = 1.0f;
+            rays.push_back(Ray{origin, direction});
+        }
+    }
+    glm::vec3 eye = max + extent + 1.0f;
+    for (uint32_t i = 0; i < resolution; i++) {
+        for (uint32_t j = 0; j < resolution; j++) {
+            glm::vec3 target = glm::vec3(gridPoint(0, i), gridPoint(1, j), (min.z + max.z) * 0.5f);
+            rays.push_back(Ray{eye, glm::normalize(target - eye)});
+        }
+    }
+
+    RayPacket packet;
+    ColliderTransform identity;
+
+    for (size_t first = 0; first < rays.size(); first += RayPacketWidth) {
+        std::span<const Ray> batch = std::span<const Ray>(rays).subspan(first, std::min<size_t>(RayPacketWidth, rays.size() - first));
+
+        PackRays(batch, identity, packet);
+        float distances[RayPacketWidth];
+        uint32_t triangles[RayPacketWidth];
+        for (uint32_t i = 0; i < packet.count; i++) {
+            Ray ray = Ray{glm::vec3(packet.ox[i], packet.oy[i], packet.oz[i]), glm::vec3(packet.dx[i], packet.dy[i], packet.dz[i])};
+            triangles[i] = bvh.ClosestTriangle(ray, distances[i]);
+            if (triangles[i] != UINT32_MAX) check.hits++;
+        }
+
+        uint32_t mismatched = 0;
+        for (RayPacketKernel kernel : kernels) {
+            PackRays(batch, identity, packet);
+            kernel(bvh, packet);
+
+            for (uint32_t i = 0; i < packet.count; i++) {
+                if (packet.triangle[i] == triangles[i] && (triangles[i] == UINT32_MAX || packet.tmax[i] == distances[i])) continue;
+
+                // a tie on a shared edge or vertex
+                Ray ray = Ray{glm::vec3(packet.ox[i], packet.oy[i], packet.oz[i]), glm::vec3(packet.dx[i], packet.dy[i], packet.dz[i])};
+                bool tie = packet.triangle[i] != UINT32_MAX && triangles[i] != UINT32_MAX && packet.tmax[i] == distances[i];
+                tie = tie && RayIntersectTriangle(ray, bvh.triangles[packet.triangle[i]]) == distances[i];
+                if (!tie) mismatched |= 1u << i;
+            }
+        }
+
+        check.rays += packet.count;
+        for (uint32_t i = 0; i < packet.count; i++) {
+            if (mismatched & (1u << i)) check.mismatches++;
+        }
+    }
+
+    return check;
+}
+
+//------------------------------------------------------------------------------------------//
+// Raycast
+//------------------------------------------------------------------------------------------//
+
+// Casts rays in packets of RayPacketWidth, hits[i] is the closest hit of rays[i] as Raycast
+// would return it. Rays that start close together and point the same way, such as a fan or a
+// grid of screen rays, visit mostly the same nodes and share the traversal. Only the rays that
+// have a slot in hits are cast.
+void RaycastPacket(std::span<const Ray> rays, const TriangleBVH& bvh, const ColliderTransform& transform, std::span<std::optional<Intersection>> hits) {
+
+    RayPacket packet;
+    size_t count = std::min(rays.size(), hits.size());
+
+    for (size_t first = 0; first < count; first += RayPacketWidth) {
+        std::span<const Ray> batch = rays.subspan(first, std::min<size_t>(RayPacketWidth, count - first));
+        PackRays(batch, transform, packet);
+        TraversePacket(bvh, packet);
+
+        for (uint32_t i = 0; i < packet.count; i++) {
+            std::optional<Intersection>& hit = hits[first + i];
+            if (packet.triangle[i] == UINT32_MAX) {
+                hit = std::nullopt;
+                continue;
+            }
+
+            const Ray& ray = batch[i];
+            const Triangle& triangle = bvh.triangles[packet.triangle[i]];
+            hit = Intersection{ray.origin + ray.direction * packet.tmax[i], glm::normalize(transform.rotation * (triangle.normal / transform.scale)), packet.tmax[i]};
+        }
+    }
+}
+
+}
+
+#endif /* ray_packet_h */
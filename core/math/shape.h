@@ -0,0 +1,324 @@
+//
+//  shape.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-14.
+//
+
+#ifndef shape_h
+#define shape_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Shape
+//------------------------------------------------------------------------------------------//
+
+// Convex shapes in local space. Primitives answer support queries in closed form, HullShape
+// falls back to a scan over its points. Y is the axis of capsules, cylinders and cones.
+enum class ShapeType {
+    Box,
+    Sphere,
+    Capsule,
+    Cylinder,
+    Cone,
+    Hull
+};
+
+constexpr size_t ShapeTypeCount = 6;
+
+constexpr int MaxFeaturePoints = 16;
+
+class Shape {
+public:
+    ShapeType type;
+    
+    Shape(ShapeType type) : type(type) {}
+    virtual ~Shape() = default;
+    
+    virtual glm::vec3 LocalSupport(const glm::vec3& direction) const = 0;
+    
+    // hint carries the previous support vertex between queries, shapes without vertices ignore it
+    virtual glm::vec3 LocalSupport(const glm::vec3& direction, uint32_t&) const { return LocalSupport(direction); }
+    
+    // The face, edge or vertex facing `direction` as a convex polygon in winding order, written to
+    // points (at most MaxFeaturePoints) and returned as a count. direction is rotated into local
+    // space but not scaled, so faces are picked by their world alignment; scale is the collider's.
+    virtual int LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* points) const {
+        points[0] = LocalSupport(scale * direction);
+        return 1;
+    }
+};
+
+class BoxShape final : public Shape {
+public:
+    static constexpr ShapeType Type = ShapeType::Box;
+    
+    glm::vec3 halfExtents;
+    
+    BoxShape(const glm::vec3& halfExtents) : Shape(ShapeType::Box), halfExtents(halfExtents) {}
+    glm::vec3 LocalSupport(const glm::vec3& direction) const override;
+    int LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* points) const override;
+};
+
+class SphereShape final : public Shape {
+public:
+    static constexpr ShapeType Type = ShapeType::Sphere;
+    
+    float radius;
+    
+    SphereShape(float radius) : Shape(ShapeType::Sphere), radius(radius) {}
+    glm::vec3 LocalSupport(const glm::vec3& direction) const override;
+};
+
+class CapsuleShape final : public Shape {
+public:
+    static constexpr ShapeType Type = ShapeType::Capsule;
+    
+    float radius, halfHeight;
+    
+    CapsuleShape(float radius, float halfHeight) : Shape(ShapeType::Capsule), radius(radius), halfHeight(halfHeight) {}
+    glm::vec3 LocalSupport(const glm::vec3& direction) const override;
+    int LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* points) const override;
+};
+
+class CylinderShape final : public Shape {
+public:
+    static constexpr ShapeType Type = ShapeType::Cylinder;
+    
+    float radius, halfHeight;
+    
+    CylinderShape(float radius, float halfHeight) : Shape(ShapeType::Cylinder), radius(radius), halfHeight(halfHeight) {}
+    glm::vec3 LocalSupport(const glm::vec3& direction) const override;
+    int LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* points) const override;
+};
+
+// apex at +halfHeight, base disc at -halfHeight
+class ConeShape final : public Shape {
+public:
+    static constexpr ShapeType Type = ShapeType::Cone;
+    
+    float radius, halfHeight;
+    
+    ConeShape(float radius, float halfHeight) : Shape(ShapeType::Cone), radius(radius), halfHeight(halfHeight) {}
+    glm::vec3 LocalSupport(const glm::vec3& direction) const override;
+};
+
+// Scans a SIMD copy of its points by default. After BuildAdjacency() the points are reduced to
+// the hull vertices and support queries hill-climb the vertex graph from the hinted vertex instead.
+class HullShape final : public Shape {
+public:
+    static constexpr ShapeType Type = ShapeType::Hull;
+    
+    std::vector<glm::vec3> points;
+    SoAPoints soaPoints;
+    std::vector<uint32_t> adjacencyOffsets, adjacency;
+    
+    HullShape(std::vector<glm::vec3> points) : Shape(ShapeType::Hull), points(std::move(points)) {
+        soaPoints = BuildSoAPoints(this->points);
+    }
+    void BuildAdjacency();
+    glm::vec3 LocalSupport(const glm::vec3& direction) const override;
+    glm::vec3 LocalSupport(const glm::vec3& direction, uint32_t& hint) const override;
+    int LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* points) const override;
+};
+
+//------------------------------------------------------------------------------------------//
+// Support functions
+//------------------------------------------------------------------------------------------//
+
+glm::vec3 BoxShape::LocalSupport(const glm::vec3& direction) const {
+    return glm::vec3(direction.x >= 0.0f ? halfExtents.x : -halfExtents.x,
+                     direction.y >= 0.0f ? halfExtents.y : -halfExtents.y,
+                     direction.z >= 0.0f ? halfExtents.z : -halfExtents.z);
+}
+
+glm::vec3 SphereShape::LocalSupport(const glm::vec3& direction) const {
+    
+    float len = glm::length(direction);
+    if (len < 1e-12f) return glm::vec3(radius, 0.0f, 0.0f);
+    
+    return direction * (radius / len);
+}
+
+glm::vec3 CapsuleShape::LocalSupport(const glm::vec3& direction) const {
+    
+    glm::vec3 tip = glm::vec3(0.0f, direction.y >= 0.0f ? halfHeight : -halfHeight, 0.0f);
+    
+    float len = glm::length(direction);
+    if (len < 1e-12f) return tip;
+    
+    return tip + direction * (radius / len);
+}
+
+glm::vec3 CylinderShape::LocalSupport(const glm::vec3& direction) const {
+    
+    float y = direction.y >= 0.0f ? halfHeight : -halfHeight;
+    float sigma = std::sqrt(direction.x * direction.x + direction.z * direction.z);
+    if (sigma < 1e-12f) return glm::vec3(0.0f, y, 0.0f);
+    
+    return glm::vec3(direction.x * (radius / sigma), y, direction.z * (radius / sigma));
+}
+
+glm::vec3 ConeShape::LocalSupport(const glm::vec3& direction) const {
+    
+    // the apex wins whenever the direction is inside the cone's half angle around +Y
+    float sinAngle = radius / std::sqrt(radius * radius + 4.0f * halfHeight * halfHeight);
+    if (direction.y > glm::length(direction) * sinAngle) return glm::vec3(0.0f, halfHeight, 0.0f);
+    
+    float sigma = std::sqrt(direction.x * direction.x + direction.z * direction.z);
+    if (sigma < 1e-12f) return glm::vec3(0.0f, -halfHeight, 0.0f);
+    
+    return glm::vec3(direction.x * (radius / sigma), -halfHeight, direction.z * (radius / sigma));
+}
+
+void HullShape::BuildAdjacency() {
+    
+    ConvexHull hull = QuickHull(points);
+    points = std::move(hull.vertices);
+    soaPoints = BuildSoAPoints(points);
+    adjacencyOffsets = std::move(hull.adjacencyOffsets);
+    adjacency = std::move(hull.adjacency);
+}
+
+glm::vec3 HullShape::LocalSupport(const glm::vec3& direction) const {
+    uint32_t hint = 0;
+    return LocalSupport(direction, hint);
+}
+
+glm::vec3 HullShape::LocalSupport(const glm::vec3& direction, uint32_t& hint) const {
+    
+    // an empty hull has no vertex to return, treat it as a point at the origin
+    if (points.empty()) return glm::vec3(0.0f);
+    if (adjacency.empty()) return points[FurthestPointIndex(soaPoints, direction)];
+    
+    // a vertex with no better neighbour is the global maximum on a convex hull
+    uint32_t current = hint < points.size() ? hint : 0;
+    float best = glm::dot(points[current], direction);
+    
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (uint32_t i = adjacencyOffsets[current]; i < adjacencyOffsets[current + 1]; i++) {
+            uint32_t neighbour = adjacency[i];
+            float dst = glm::dot(points[neighbour], direction);
+            if (dst > best) {
+                best = dst;
+                current = neighbour;
+                improved = true;
+            }
+        }
+    }
+    
+    hint = current;
+    return points[current];
+}
+
+//------------------------------------------------------------------------------------------//
+// Support features
+//------------------------------------------------------------------------------------------//
+
+// tilt, as a sine, up to which a face or side still counts as facing the direction
+constexpr float FeatureTolerance = 0.05f;
+
+// the face whose normal is closest to the direction, scaling does not turn the faces of a box
+int BoxShape::LocalSupportFeature(const glm::vec3& direction, const glm::vec3&, glm::vec3* points) const {
+    
+    glm::vec3 magnitude = glm::abs(direction);
+    int axis = magnitude.x >= magnitude.y && magnitude.x >= magnitude.z ? 0 : (magnitude.y >= magnitude.z ? 1 : 2);
+    int u = (axis + 1) % 3, v = (axis + 2) % 3;
+    
+    glm::vec3 corner = glm::vec3(0.0f);
+    corner[axis] = direction[axis] >= 0.0f ? halfExtents[axis] : -halfExtents[axis];
+    
+    const float signs[4][2] = {{1.0f, 1.0f}, {-1.0f, 1.0f}, {-1.0f, -1.0f}, {1.0f, -1.0f}};
+    for (int i = 0; i < 4; i++) {
+        points[i] = corner;
+        points[i][u] = signs[i][0] * halfExtents[u];
+        points[i][v] = signs[i][1] * halfExtents[v];
+    }
+    return 4;
+}
+
+// the segment of the side facing a direction perpendicular to the axis, otherwise a point
+int CapsuleShape::LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* points) const {
+    
+    glm::vec3 local = scale * direction;
+    float len = glm::length(local);
+    if (len < 1e-12f || std::abs(local.y) > FeatureTolerance * len) {
+        points[0] = LocalSupport(local);
+        return 1;
+    }
+    
+    glm::vec3 side = glm::vec3(local.x, 0.0f, local.z) * (radius / std::sqrt(local.x * local.x + local.z * local.z));
+    points[0] = side + glm::vec3(0.0f,  halfHeight, 0.0f);
+    points[1] = side + glm::vec3(0.0f, -halfHeight, 0.0f);
+    return 2;
+}
+
+// a cap as a polygon when the direction follows the axis, a side segment when it is perpendicular
+int CylinderShape::LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* points) const {
+    
+    glm::vec3 local = scale * direction;
+    float len = glm::length(local);
+    float sigma = std::sqrt(local.x * local.x + local.z * local.z);
+    
+    if (len >= 1e-12f && sigma <= FeatureTolerance * len) {
+        float y = local.y >= 0.0f ? halfHeight : -halfHeight;
+        const int segments = 8;
+        for (int i = 0; i < segments; i++) {
+            float angle = 2.0f * 3.14159265358f * float(i) / float(segments);
+            points[i] = glm::vec3(std::cos(angle) * radius, y, std::sin(angle) * radius);
+        }
+        return segments;
+    }
+    if (len >= 1e-12f && std::abs(local.y) <= FeatureTolerance * len) {
+        glm::vec3 side = glm::vec3(local.x, 0.0f, local.z) * (radius / sigma);
+        points[0] = side + glm::vec3(0.0f,  halfHeight, 0.0f);
+        points[1] = side + glm::vec3(0.0f, -halfHeight, 0.0f);
+        return 2;
+    }
+    
+    points[0] = LocalSupport(local);
+    return 1;
+}
+
+// every point within the tolerance of the support plane, ordered by angle around their centroid
+int HullShape::LocalSupportFeature(const glm::vec3& direction, const glm::vec3& scale, glm::vec3* out) const {
+    
+    glm::vec3 local = scale * direction;
+    if (points.empty()) return 0;
+    
+    float maxDst = -FLT_MAX, minDst = FLT_MAX;
+    for (const glm::vec3& point : points) {
+        float dst = glm::dot(point, local);
+        maxDst = std::max(maxDst, dst);
+        minDst = std::min(minDst, dst);
+    }
+    float threshold = maxDst - FeatureTolerance * (maxDst - minDst);
+    
+    int count = 0;
+    for (const glm::vec3& point : points) {
+        if (glm::dot(point, local) >= threshold && count < MaxFeaturePoints) out[count++] = point;
+    }
+    if (count < 3) return count;
+    
+    // order in a plane perpendicular to the direction, as seen in world space (after scaling)
+    glm::vec3 normal = glm::normalize(local / (scale * scale));
+    glm::vec3 tangent = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    tangent = glm::normalize(glm::cross(normal, tangent));
+    glm::vec3 bitangent = glm::cross(normal, tangent);
+    
+    glm::vec3 centroid = glm::vec3(0.0f);
+    for (int i = 0; i < count; i++) centroid += out[i];
+    centroid /= float(count);
+    
+    std::sort(out, out + count, [&](const glm::vec3& a, const glm::vec3& b) {
+        glm::vec3 da = a - centroid, db = b - centroid;
+        return std::atan2(glm::dot(da, bitangent), glm::dot(da, tangent)) < std::atan2(glm::dot(db, bitangent), glm::dot(db, tangent));
+    });
+    return count;
+}
+
+}
+
+#endif /* shape_h */
@@ -0,0 +1,205 @@
+//
+//  signed_volume.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-22.
+//
+
+#ifndef signed_volume_h
+#define signed_volume_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Signed volumes
+//------------------------------------------------------------------------------------------//
+
+// Closest point to the origin on a simplex of up to four points, as barycentric weights over the
+// smallest sub-simplex that holds it. Coordinates are ratios of signed volumes, and of signed
+// areas projected on the axis plane where the triangle is largest, so nothing divides by a dot
+// product of nearly parallel edges. Flat triangles and tetrahedra fall back to their edges and
+// faces. (Montanari, Petrinic and Barbieri, "Improving the GJK algorithm for faster and more
+// reliable distance queries between convex objects", 2017)
+struct SimplexSolution {
+    int indices[4];
+    float weights[4];
+    int count = 0;
+};
+
+// relative size below which a triangle or tetrahedron counts as flat
+constexpr float SignedVolumeDegenerate = 1e-6f;
+
+glm::vec3 SolutionPoint(const glm::vec3* points, const SimplexSolution& solution) {
+
+    glm::vec3 point = glm::vec3(0.0f);
+    for (int i = 0; i < solution.count; i++) point += solution.weights[i] * points[solution.indices[i]];
+    return point;
+}
+
+// keeps whichever candidate is closer to the origin
+void KeepClosest(const glm::vec3* points, const SimplexSolution& candidate, SimplexSolution& best, float& bestDistance) {
+
+    glm::vec3 point = SolutionPoint(points, candidate);
+    float distance = glm::dot(point, point);
+    if (distance < bestDistance) {
+        bestDistance = distance;
+        best = candidate;
+    }
+}
+
+SimplexSolution SignedVolume1D(const glm::vec3* points, int i0, int i1) {
+
+    const glm::vec3& a = points[i0];
+    const glm::vec3& b = points[i1];
+    glm::vec3 ab = b - a;
+
+    SimplexSolution solution;
+    float length2 = glm::dot(ab, ab);
+
+    // a segment of two equal points is the nearer one
+    if (length2 <= 1e-12f * std::max(glm::dot(a, a), glm::dot(b, b))) {
+        solution.indices[0] = glm::dot(a, a) <= glm::dot(b, b) ? i0 : i1;
+        solution.weights[0] = 1.0f;
+        solution.count = 1;
+        return solution;
+    }
+
+    // project the origin onto the line, then measure along the axis where the segment is longest
+    glm::vec3 p = a - ab * (glm::dot(a, ab) / length2);
+
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (std::abs(ab[k]) > std::abs(ab[axis])) axis = k;
+    }
+    float mu = b[axis] - a[axis];
+    float ca = b[axis] - p[axis];
+    float cb = p[axis] - a[axis];
+
+    if (ca * mu > 0.0f && cb * mu >= 0.0f) {
+        solution.indices[0] = i0;
+        solution.indices[1] = i1;
+        solution.weights[0] = ca / mu;
+        solution.weights[1] = cb / mu;
+        solution.count = 2;
+    }
+    else {
+        solution.indices[0] = ca * mu <= 0.0f ? i1 : i0;
+        solution.weights[0] = 1.0f;
+        solution.count = 1;
+    }
+    return solution;
+}
+
+SimplexSolution SignedVolume2D(const glm::vec3* points, int i0, int i1, int i2) {
+
+    const glm::vec3& a = points[i0];
+    const glm::vec3& b = points[i1];
+    const glm::vec3& c = points[i2];
+    const int vertices[3] = {i0, i1, i2};
+
+    glm::vec3 n = glm::cross(b - a, c - a);
+    float n2 = glm::dot(n, n);
+
+    SimplexSolution best;
+    float bestDistance = FLT_MAX;
+
+    // collinear, the closest point is on one of the edges
+    if (n2 <= SignedVolumeDegenerate * glm::dot(b - a, b - a) * glm::dot(c - a, c - a)) {
+        KeepClosest(points, SignedVolume1D(points, i0, i1), best, bestDistance);
+        KeepClosest(points, SignedVolume1D(points, i0, i2), best, bestDistance);
+        KeepClosest(points, SignedVolume1D(points, i1, i2), best, bestDistance);
+        return best;
+    }
+
+    // the origin projected onto the plane, then areas in the axis plane where the triangle is largest
+    glm::vec3 p = n * (glm::dot(a, n) / n2);
+
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (std::abs(n[k]) > std::abs(n[axis])) axis = k;
+    }
+    int x = (axis + 1) % 3, y = (axis + 2) % 3;
+    auto area = [x, y](const glm::vec3& u, const glm::vec3& v, const glm::vec3& w) {
+        return (v[x] - u[x]) * (w[y] - u[y]) - (v[y] - u[y]) * (w[x] - u[x]);
+    };
+
+    float mu = n[axis];
+    float cofactors[3] = {area(p, b, c), area(a, p, c), area(a, b, p)};
+
+    bool inside = true;
+    for (int j = 0; j < 3; j++) {
+        if (cofactors[j] * mu >= 0.0f) continue;
+
+        // the origin is beyond the edge opposite vertex j
+        inside = false;
+        KeepClosest(points, SignedVolume1D(points, vertices[(j + 1) % 3], vertices[(j + 2) % 3]), best, bestDistance);
+    }
+    if (!inside) return best;
+
+    for (int j = 0; j < 3; j++) {
+        best.indices[j] = vertices[j];
+        best.weights[j] = cofactors[j] / mu;
+    }
+    best.count = 3;
+    return best;
+}
+
+SimplexSolution SignedVolume3D(const glm::vec3* points) {
+
+    const glm::vec3& a = points[0];
+    const glm::vec3& b = points[1];
+    const glm::vec3& c = points[2];
+    const glm::vec3& d = points[3];
+
+    // cofactor j is the volume with vertex j swapped for the origin, they add up to det
+    auto volume = [](const glm::vec3& p, const glm::vec3& q, const glm::vec3& r, const glm::vec3& s) {
+        return glm::dot(q - p, glm::cross(r - p, s - p));
+    };
+    const glm::vec3 origin = glm::vec3(0.0f);
+    float det = volume(a, b, c, d);
+    float cofactors[4] = {volume(origin, b, c, d), volume(a, origin, c, d), volume(a, b, origin, d), volume(a, b, c, origin)};
+    static const int faces[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+
+    SimplexSolution best;
+    float bestDistance = FLT_MAX;
+
+    float scale = glm::length(b - a) * glm::length(c - a) * glm::length(d - a);
+    bool flat = std::abs(det) <= SignedVolumeDegenerate * scale;
+
+    bool inside = !flat;
+    for (int j = 0; j < 4; j++) {
+        if (!flat && cofactors[j] * det >= 0.0f) continue;
+
+        // the origin is beyond the face opposite vertex j, or the tetrahedron has no inside
+        inside = false;
+        KeepClosest(points, SignedVolume2D(points, faces[j][0], faces[j][1], faces[j][2]), best, bestDistance);
+    }
+    if (!inside) return best;
+
+    for (int j = 0; j < 4; j++) {
+        best.indices[j] = j;
+        best.weights[j] = cofactors[j] / det;
+    }
+    best.count = 4;
+    return best;
+}
+
+// A count of 4 means the origin is inside the tetrahedron or on its boundary.
+SimplexSolution SignedVolumes(const glm::vec3* points, int count) {
+
+    switch (count) {
+        case 2: return SignedVolume1D(points, 0, 1);
+        case 3: return SignedVolume2D(points, 0, 1, 2);
+        case 4: return SignedVolume3D(points);
+    }
+
+    SimplexSolution solution;
+    solution.indices[0] = 0;
+    solution.weights[0] = 1.0f;
+    solution.count = count > 0 ? 1 : 0;
+    return solution;
+}
+
+}
+
+#endif /* signed_volume_h */
@@ -8,45 +8,186 @@
 #ifndef support_h
 #define support_h
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SUPPORT_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define SUPPORT_X86_SIMD 0
+#endif
+
+// the SIMD kernels use separate multiplies and adds, the scalar path must not be fused into
+// FMAs either or the results stop being bit-identical
+#if defined(__clang__)
+#define SUPPORT_NO_CONTRACT _Pragma("clang fp contract(off)")
+#define SUPPORT_NO_CONTRACT_ATTRIBUTE
+#elif defined(__GNUC__)
+#define SUPPORT_NO_CONTRACT
+#define SUPPORT_NO_CONTRACT_ATTRIBUTE __attribute__((optimize("fp-contract=off")))
+#else
+#define SUPPORT_NO_CONTRACT
+#define SUPPORT_NO_CONTRACT_ATTRIBUTE
+#endif
+
 namespace core {
 
 //------------------------------------------------------------------------------------------//
-// Helper
+// Structure of arrays
 //------------------------------------------------------------------------------------------//
 
-glm::vec3 GetFurthestPoint(std::vector<glm::vec3> vertices, glm::vec3 direction) {
+constexpr uint32_t SoAWidth = 8;
+
+// x[], y[] and z[] are padded to SoAWidth with copies of the first point, which can never win
+// over the real first point because ties resolve to the lowest index
+struct SoAPoints {
+    std::vector<float> x, y, z;
+    uint32_t count = 0;
+};
 
-    glm::vec3 max = vertices[0];
-    float dstMax = glm::dot(max, direction);
+SoAPoints BuildSoAPoints(std::span<const glm::vec3> points) {
+    
+    SoAPoints soa;
+    soa.count = (uint32_t)points.size();
+    if (points.empty()) return soa;
+    
+    size_t padded = (points.size() + SoAWidth - 1) / SoAWidth * SoAWidth;
+    soa.x.resize(padded, points[0].x);
+    soa.y.resize(padded, points[0].y);
+    soa.z.resize(padded, points[0].z);
+    
+    for (size_t i = 0; i < points.size(); i++) {
+        soa.x[i] = points[i].x;
+        soa.y[i] = points[i].y;
+        soa.z[i] = points[i].z;
+    }
+    return soa;
+}
+
+//------------------------------------------------------------------------------------------//
+// Furthest point kernels
+//------------------------------------------------------------------------------------------//
 
-    for (const glm::vec3& vertex : vertices) {
-        float dst = glm::dot(vertex, direction);
+// all kernels return the lowest index among the points with the largest (x*dx + y*dy) + z*dz
+
+SUPPORT_NO_CONTRACT_ATTRIBUTE
+uint32_t FurthestPointIndexScalar(const SoAPoints& points, const glm::vec3& direction) {
+    SUPPORT_NO_CONTRACT
+    
+    uint32_t max = 0;
+    float dstMax = -FLT_MAX;
+    
+    for (uint32_t i = 0; i < points.count; i++) {
+        float dst = points.x[i] * direction.x;
+        dst = dst + points.y[i] * direction.y;
+        dst = dst + points.z[i] * direction.z;
         if (dst > dstMax) {
             dstMax = dst;
-            max = vertex;
+            max = i;
         }
     }
-
     return max;
 }
 
-bool SameDirection(glm::vec3 direction, glm::vec3& AO) {
-    return glm::dot(direction, AO) > 0;
+#if SUPPORT_X86_SIMD
+
+// picks the best lane, ties go to the lowest point index
+inline uint32_t ReduceFurthestLanes(const float* dst, const int32_t* index, int lanes) {
+    
+    float dstMax = dst[0];
+    int32_t max = index[0];
+    
+    for (int i = 1; i < lanes; i++) {
+        if (dst[i] > dstMax || (dst[i] == dstMax && index[i] < max)) {
+            dstMax = dst[i];
+            max = index[i];
+        }
+    }
+    return (uint32_t)max;
 }
 
+__attribute__((target("sse4.1")))
+uint32_t FurthestPointIndexSSE41(const SoAPoints& points, const glm::vec3& direction) {
+    
+    const __m128 dx = _mm_set1_ps(direction.x);
+    const __m128 dy = _mm_set1_ps(direction.y);
+    const __m128 dz = _mm_set1_ps(direction.z);
+    
+    __m128 best = _mm_set1_ps(-FLT_MAX);
+    __m128i bestIndex = _mm_setzero_si128();
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    
+    size_t padded = points.x.size();
+    for (size_t i = 0; i < padded; i += 4) {
+        __m128 dst = _mm_mul_ps(_mm_loadu_ps(&points.x[i]), dx);
+        dst = _mm_add_ps(dst, _mm_mul_ps(_mm_loadu_ps(&points.y[i]), dy));
+        dst = _mm_add_ps(dst, _mm_mul_ps(_mm_loadu_ps(&points.z[i]), dz));
+        
+        __m128 greater = _mm_cmpgt_ps(dst, best);
+        best = _mm_blendv_ps(best, dst, greater);
+        bestIndex = _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(bestIndex), _mm_castsi128_ps(index), greater));
+        index = _mm_add_epi32(index, step);
+    }
+    
+    alignas(16) float dst[4];
+    alignas(16) int32_t indices[4];
+    _mm_store_ps(dst, best);
+    _mm_store_si128((__m128i*)indices, bestIndex);
+    
+    return ReduceFurthestLanes(dst, indices, 4);
+}
+
+__attribute__((target("avx2")))
+uint32_t FurthestPointIndexAVX2(const SoAPoints& points, const glm::vec3& direction) {
+    
+    const __m256 dx = _mm256_set1_ps(direction.x);
+    const __m256 dy = _mm256_set1_ps(direction.y);
+    const __m256 dz = _mm256_set1_ps(direction.z);
+    
+    __m256 best = _mm256_set1_ps(-FLT_MAX);
+    __m256i bestIndex = _mm256_setzero_si256();
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    
+    size_t padded = points.x.size();
+    for (size_t i = 0; i < padded; i += 8) {
+        __m256 dst = _mm256_mul_ps(_mm256_loadu_ps(&points.x[i]), dx);
+        dst = _mm256_add_ps(dst, _mm256_mul_ps(_mm256_loadu_ps(&points.y[i]), dy));
+        dst = _mm256_add_ps(dst, _mm256_mul_ps(_mm256_loadu_ps(&points.z[i]), dz));
+        
+        __m256 greater = _mm256_cmp_ps(dst, best, _CMP_GT_OQ);
+        best = _mm256_blendv_ps(best, dst, greater);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_castps_si256(greater));
+        index = _mm256_add_epi32(index, step);
+    }
+    
+    alignas(32) float dst[8];
+    alignas(32) int32_t indices[8];
+    _mm256_store_ps(dst, best);
+    _mm256_store_si256((__m256i*)indices, bestIndex);
+    
+    return ReduceFurthestLanes(dst, indices, 8);
+}
+
+#endif
+
 //------------------------------------------------------------------------------------------//
-// Support
+// Dispatch
 //------------------------------------------------------------------------------------------//
 
-glm::vec3 Support(const std::vector<Vertex> colliderVertices, glm::vec3 direction) {
+using FurthestPointKernel = uint32_t (*)(const SoAPoints&, const glm::vec3&);
 
-    std::vector<glm::vec3> vertices;
-    
-    for (int i = 0; i < colliderVertices.size(); i++) {
-        const glm::vec3& vertex = glm::vec3(colliderVertices[i].vertex);
-        vertices.push_back(vertex);
-    }
-    return GetFurthestPoint(vertices, direction);
+FurthestPointKernel SelectFurthestPointKernel() {
+#if SUPPORT_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))   return FurthestPointIndexAVX2;
+    if (__builtin_cpu_supports("sse4.1")) return FurthestPointIndexSSE41;
+#endif
+    return FurthestPointIndexScalar;
+}
+
+uint32_t FurthestPointIndex(const SoAPoints& points, const glm::vec3& direction) {
+    static const FurthestPointKernel kernel = SelectFurthestPointKernel();
+    return kernel(points, direction);
 }
 
 }
@@ -0,0 +1,326 @@
+//
+//  triangle_bvh.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-25.
+//
+
+#ifndef triangle_bvh_h
+#define triangle_bvh_h
+
+namespace core {
+
+// 32 bytes, two nodes to a cache line
+struct BVHNode {
+    glm::vec3 min;
+    // first triangle of a leaf, or the left child of an inner node (the right child follows it)
+    uint32_t first;
+    glm::vec3 max;
+    // triangles in a leaf, 0 for inner nodes
+    uint32_t count;
+};
+
+constexpr int BVHBinCount = 12;
+
+// deeper than this every node becomes a leaf, which bounds the traversal stack
+constexpr int BVHMaxDepth = 48;
+constexpr int BVHStackSize = BVHMaxDepth + 2;
+
+// relative cost of stepping into a node against testing one triangle
+constexpr float BVHTraversalCost = 1.0f;
+
+// node boxes grow by this fraction of their coordinates' magnitude
+constexpr float BVHBoundsPadding = 1e-5f;
+
+//------------------------------------------------------------------------------------------//
+// Triangle BVH
+//------------------------------------------------------------------------------------------//
+
+// Bounding volume hierarchy over a triangle mesh, built once in the mesh's local space and kept
+// in a flat node array with the root at 0. Splits are picked by the surface area heuristic over
+// binned centroids, and the triangles are reordered so every leaf owns a contiguous range.
+class TriangleBVH {
+public:
+    std::vector<Triangle> triangles;
+    std::vector<BVHNode> nodes;
+
+    TriangleBVH() = default;
+    TriangleBVH(std::vector<Triangle> triangles);
+
+    void Build(std::vector<Triangle> triangles);
+    bool Empty() const { return nodes.empty(); }
+
+    // closest hit in the BVH's own space
+    std::optional<Intersection> Raycast(const Ray& ray) const;
+    // index of the closest triangle hit and its distance, UINT32_MAX when nothing is hit
+    uint32_t ClosestTriangle(const Ray& ray, float& distance) const;
+
+private:
+    std::vector<glm::vec3> centroids;
+
+    void UpdateBounds(BVHNode& node);
+    void Subdivide(uint32_t index, int depth);
+    bool FindSplit(const BVHNode& node, int& axis, float& position);
+};
+
+TriangleBVH::TriangleBVH(std::vector<Triangle> triangles) {
+    Build(std::move(triangles));
+}
+
+void TriangleBVH::Build(std::vector<Triangle> input) {
+
+    triangles = std::move(input);
+    nodes.clear();
+    if (triangles.empty()) return;
+
+    centroids.resize(triangles.size());
+    for (size_t i = 0; i < triangles.size(); i++) centroids[i] = (triangles[i].a + triangles[i].b + triangles[i].c) / 3.0f;
+
+    // a binary tree over n leaves has at most 2n - 1 nodes
+    nodes.reserve(triangles.size() * 2);
+    nodes.push_back(BVHNode{glm::vec3(0.0f), 0, glm::vec3(0.0f), (uint32_t)triangles.size()});
+    UpdateBounds(nodes[0]);
+    Subdivide(0, 0);
+
+    nodes.shrink_to_fit();
+    centroids.clear();
+    centroids.shrink_to_fit();
+}
+
+// Boxes are padded by a few float steps of their coordinates, so a triangle on a box face is
+// strictly inside: the slab test can then never round to a later entry than the triangle's own
+// hit, nor reject a ray that runs along the face.
+void TriangleBVH::UpdateBounds(BVHNode& node) {
+
+    node.min = glm::vec3(FLT_MAX);
+    node.max = glm::vec3(-FLT_MAX);
+    for (uint32_t i = node.first; i < node.first + node.count; i++) {
+        node.min = glm::min(node.min, triangles[i].minBound);
+        node.max = glm::max(node.max, triangles[i].maxBound);
+    }
+
+    glm::vec3 padding = (glm::abs(node.min) + glm::abs(node.max)) * BVHBoundsPadding + BVHBoundsPadding;
+    node.min -= padding;
+    node.max += padding;
+}
+
+// Bins the centroids along each axis and sweeps the bin boundaries for the cheapest split.
+// Returns false when keeping the node as a leaf is cheaper.
+bool TriangleBVH::FindSplit(const BVHNode& node, int& axis, float& position) {
+
+    glm::vec3 centroidMin = glm::vec3(FLT_MAX), centroidMax = glm::vec3(-FLT_MAX);
+    for (uint32_t i = node.first; i < node.first + node.count; i++) {
+        centroidMin = glm::min(centroidMin, centroids[i]);
+        centroidMax = glm::max(centroidMax, centroids[i]);
+    }
+
+    struct Bin {
+        glm::vec3 min = glm::vec3(FLT_MAX), max = glm::vec3(-FLT_MAX);
+        uint32_t count = 0;
+    };
+
+    float bestCost = FLT_MAX;
+
+    for (int k = 0; k < 3; k++) {
+        float extent = centroidMax[k] - centroidMin[k];
+        if (extent <= 0.0f) continue;
+
+        Bin bins[BVHBinCount];
+        float scale = BVHBinCount / extent;
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            int b = std::min(BVHBinCount - 1, (int)((centroids[i][k] - centroidMin[k]) * scale));
+            bins[b].count++;
+            bins[b].min = glm::min(bins[b].min, triangles[i].minBound);
+            bins[b].max = glm::max(bins[b].max, triangles[i].maxBound);
+        }
+
+        // areas and counts left of each boundary, then swept in from the right
+        float leftArea[BVHBinCount - 1];
+        uint32_t leftCount[BVHBinCount - 1];
+        glm::vec3 min = glm::vec3(FLT_MAX), max = glm::vec3(-FLT_MAX);
+        uint32_t count = 0;
+        for (int b = 0; b < BVHBinCount - 1; b++) {
+            count += bins[b].count;
+            min = glm::min(min, bins[b].min);
+            max = glm::max(max, bins[b].max);
+            leftCount[b] = count;
+            leftArea[b] = count ? AABBSurfaceArea(min, max) : 0.0f;
+        }
+
+        min = glm::vec3(FLT_MAX);
+        max = glm::vec3(-FLT_MAX);
+        count = 0;
+        for (int b = BVHBinCount - 1; b > 0; b--) {
+            count += bins[b].count;
+            min = glm::min(min, bins[b].min);
+            max = glm::max(max, bins[b].max);
+
+            if (count == 0 || leftCount[b - 1] == 0) continue;
+            float cost = leftCount[b - 1] * leftArea[b - 1] + count * AABBSurfaceArea(min, max);
+            if (cost < bestCost) {
+                bestCost = cost;
+                axis = k;
+                position = centroidMin[k] + b / scale;
+            }
+        }
+    }
+
+    if (bestCost == FLT_MAX) return false;
+
+    // SAH: traversal plus the expected triangle tests of both children, against testing them all
+    float area = AABBSurfaceArea(node.min, node.max);
+    return area <= 0.0f || BVHTraversalCost + bestCost / area < (float)node.count;
+}
+
+void TriangleBVH::Subdivide(uint32_t index, int depth) {
+
+    BVHNode node = nodes[index];
+    if (node.count <= 2 || depth >= BVHMaxDepth) return;
+
+    int axis = 0;
+    float position = 0.0f;
+    if (!FindSplit(node, axis, position)) return;
+
+    // partition the range, moving centroids along with their triangles
+    uint32_t i = node.first, j = node.first + node.count;
+    while (i < j) {
+        if (centroids[i][axis] < position) {
+            i++;
+        }
+        else {
+            j--;
+            std::swap(triangles[i], triangles[j]);
+            std::swap(centroids[i], centroids[j]);
+        }
+    }
+
+    uint32_t leftCount = i - node.first;
+    if (leftCount == 0 || leftCount == node.count) return;
+
+    uint32_t left = (uint32_t)nodes.size();
+    nodes.push_back(BVHNode{glm::vec3(0.0f), node.first, glm::vec3(0.0f), leftCount});
+    nodes.push_back(BVHNode{glm::vec3(0.0f), i, glm::vec3(0.0f), node.count - leftCount});
+    UpdateBounds(nodes[left]);
+    UpdateBounds(nodes[left + 1]);
+
+    nodes[index].first = left;
+    nodes[index].count = 0;
+
+    Subdivide(left, depth + 1);
+    Subdivide(left + 1, depth + 1);
+}
+
+// 1 / direction for the slab tests. Components too small to invert become a huge finite value
+// instead of infinity: a ray lying in a slab plane would otherwise get 0 * inf = NaN there, which
+// the scalar and SIMD min/max resolve differently.
+inline glm::vec3 RayInverseDirection(const glm::vec3& direction) {
+
+    glm::vec3 inverse;
+    for (int k = 0; k < 3; k++) inverse[k] = std::abs(direction[k]) < 1e-30f ? 1e30f : 1.0f / direction[k];
+    return inverse;
+}
+
+// slab test against a node, the entry distance or FLT_MAX when the ray misses it before maxDistance
+inline float RayNodeDistance(const Ray& ray, const glm::vec3& invDir, const BVHNode& node, float maxDistance) {
+
+    glm::vec3 t0s = (node.min - ray.origin) * invDir;
+    glm::vec3 t1s = (node.max - ray.origin) * invDir;
+    glm::vec3 tsmaller = glm::min(t0s, t1s);
+    glm::vec3 tbigger  = glm::max(t0s, t1s);
+
+    float tmin = std::max({tsmaller.x, tsmaller.y, tsmaller.z, 0.0f});
+    float tmax = std::min({tbigger.x, tbigger.y, tbigger.z, maxDistance});
+    return tmax >= tmin ? tmin : FLT_MAX;
+}
+
+// Stack traversal, nearer child first. A child is skipped once its box starts beyond the
+// closest hit found so far.
+uint32_t TriangleBVH::ClosestTriangle(const Ray& ray, float& distance) const {
+
+    if (nodes.empty()) return UINT32_MAX;
+
+    glm::vec3 invDir = RayInverseDirection(ray.direction);
+    float closest = FLT_MAX;
+    uint32_t hit = UINT32_MAX;
+
+    if (RayNodeDistance(ray, invDir, nodes[0], closest) == FLT_MAX) return UINT32_MAX;
+
+    uint32_t stack[BVHStackSize];
+    int size = 0;
+    uint32_t index = 0;
+
+    while (true) {
+        const BVHNode& node = nodes[index];
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                std::optional<float> t = RayIntersectTriangle(ray, triangles[i]);
+                if (t && *t < closest) {
+                    closest = *t;
+                    hit = i;
+                }
+            }
+        }
+        else {
+            uint32_t nearChild = node.first, farChild = node.first + 1;
+            float nearDistance = RayNodeDistance(ray, invDir, nodes[nearChild], closest);
+            float farDistance  = RayNodeDistance(ray, invDir, nodes[farChild], closest);
+            if (farDistance < nearDistance) {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+
+            if (nearDistance != FLT_MAX) {
+                if (farDistance != FLT_MAX) stack[size++] = farChild;
+                index = nearChild;
+                continue;
+            }
+        }
+
+        // popped nodes may now start beyond a closer hit
+        index = UINT32_MAX;
+        while (size > 0) {
+            uint32_t candidate = stack[--size];
+            if (RayNodeDistance(ray, invDir, nodes[candidate], closest) != FLT_MAX) {
+                index = candidate;
+                break;
+            }
+        }
+        if (index == UINT32_MAX) break;
+    }
+
+    distance = closest;
+    return hit;
+}
+
+std::optional<Intersection> TriangleBVH::Raycast(const Ray& ray) const {
+
+    float distance;
+    uint32_t hit = ClosestTriangle(ray, distance);
+    if (hit == UINT32_MAX) return std::nullopt;
+    return Intersection{ray.origin + ray.direction * distance, triangles[hit].normal, distance};
+}
+
+//------------------------------------------------------------------------------------------//
+// Object space raycast
+//------------------------------------------------------------------------------------------//
+
+// The ray is moved into the local space of the BVH instead of moving the mesh: the direction is
+// not renormalized, so the ray parameter and the returned distance are the same in both spaces.
+std::optional<Intersection> Raycast(const Ray& ray, const TriangleBVH& bvh, const ColliderTransform& transform) {
+
+    glm::mat3 inverseRotation = glm::transpose(transform.rotation);
+    Ray local = Ray{inverseRotation * (ray.origin - transform.translation) / transform.scale, inverseRotation * ray.direction / transform.scale};
+
+    std::optional<Intersection> hit = bvh.Raycast(local);
+    if (!hit) return std::nullopt;
+
+    // normals take the inverse transpose, so the scale divides instead of multiplies
+    hit->intersectionPoint = ray.origin + ray.direction * hit->distance;
+    hit->normal = glm::normalize(transform.rotation * (hit->normal / transform.scale));
+    return hit;
+}
+
+}
+
+#endif /* triangle_bvh_h */
@@ -0,0 +1,336 @@
+//
+//  aabb_tree.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-19.
+//
+
+#ifndef aabb_tree_h
+#define aabb_tree_h
+
+#include <unordered_map>
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Dynamic AABB tree
+//------------------------------------------------------------------------------------------//
+
+constexpr int32_t AABBTreeNull = -1;
+
+// Leaves hold one object each with its bounds grown by a margin (the fat box). Internal nodes
+// always have two children. Free nodes are chained through parent.
+struct AABBTreeNode {
+    glm::vec3 min, max;
+    RObject* object;
+    int32_t parent;
+    int32_t child1, child2;
+    int32_t height;
+
+    bool IsLeaf() const { return child1 == AABBTreeNull; }
+};
+
+// Incremental broad phase for moving objects. Insert, Remove and Move are O(log n): Move only
+// reinserts an object once its tight bounds leave the fat box, and every insertion or removal
+// rebalances its path to the root with AVL style rotations.
+class AABBTree {
+public:
+    std::vector<AABBTreeNode> nodes;
+    float margin;
+
+    AABBTree(float margin = 0.5f) : margin(margin) {}
+
+    void Insert(RObject* obj);
+    void Remove(RObject* obj);
+    // returns true if the object left its fat box and was reinserted
+    bool Move(RObject* obj);
+    void QueryObjects(const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) const;
+
+    int32_t Root() const { return root; }
+    int32_t Height() const { return root == AABBTreeNull ? 0 : nodes[root].height; }
+
+private:
+    int32_t root = AABBTreeNull;
+    int32_t freeList = AABBTreeNull;
+    std::unordered_map<RObject*, int32_t> leaves;
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    int32_t Balance(int32_t a);
+};
+
+//------------------------------------------------------------------------------------------//
+// Node pool
+//------------------------------------------------------------------------------------------//
+
+int32_t AABBTree::AllocateNode() {
+
+    int32_t node;
+    if (freeList != AABBTreeNull) {
+        node = freeList;
+        freeList = nodes[node].parent;
+    }
+    else {
+        node = (int32_t)nodes.size();
+        nodes.push_back(AABBTreeNode{});
+    }
+
+    nodes[node].object = nullptr;
+    nodes[node].parent = AABBTreeNull;
+    nodes[node].child1 = AABBTreeNull;
+    nodes[node].child2 = AABBTreeNull;
+    nodes[node].height = 0;
+    return node;
+}
+
+void AABBTree::FreeNode(int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+//------------------------------------------------------------------------------------------//
+// Insert / remove
+//------------------------------------------------------------------------------------------//
+
+void AABBTree::Insert(RObject* obj) {
+
+    if (!obj || leaves.count(obj)) return;
+
+    int32_t leaf = AllocateNode();
+    obj->GetWorldBounds(nodes[leaf].min, nodes[leaf].max);
+    nodes[leaf].min -= glm::vec3(margin);
+    nodes[leaf].max += glm::vec3(margin);
+    nodes[leaf].object = obj;
+
+    leaves[obj] = leaf;
+    InsertLeaf(leaf);
+}
+
+void AABBTree::Remove(RObject* obj) {
+
+    auto it = leaves.find(obj);
+    if (it == leaves.end()) return;
+
+    RemoveLeaf(it->second);
+    FreeNode(it->second);
+    leaves.erase(it);
+}
+
+bool AABBTree::Move(RObject* obj) {
+
+    auto it = leaves.find(obj);
+    if (it == leaves.end()) return false;
+
+    int32_t leaf = it->second;
+    glm::vec3 min, max;
+    obj->GetWorldBounds(min, max);
+    if (AABBContains(nodes[leaf].min, nodes[leaf].max, min, max)) return false;
+
+    RemoveLeaf(leaf);
+    nodes[leaf].min = min - glm::vec3(margin);
+    nodes[leaf].max = max + glm::vec3(margin);
+    InsertLeaf(leaf);
+    return true;
+}
+
+// descends towards the sibling with the lowest surface area increase (Catto's branch and bound
+// cost without the priority queue), then walks back up refitting and rebalancing
+void AABBTree::InsertLeaf(int32_t leaf) {
+
+    if (root == AABBTreeNull) {
+        root = leaf;
+        nodes[root].parent = AABBTreeNull;
+        return;
+    }
+
+    glm::vec3 leafMin = nodes[leaf].min, leafMax = nodes[leaf].max;
+    int32_t index = root;
+    while (!nodes[index].IsLeaf()) {
+        int32_t child1 = nodes[index].child1;
+        int32_t child2 = nodes[index].child2;
+
+        float area = AABBSurfaceArea(nodes[index].min, nodes[index].max);
+        float combinedArea = AABBSurfaceArea(glm::min(nodes[index].min, leafMin), glm::max(nodes[index].max, leafMax));
+
+        // cost of making a new parent for this node and the leaf, and the inherited cost of going deeper
+        float cost = 2.0f * combinedArea;
+        float inheritance = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t child) {
+            glm::vec3 min = glm::min(nodes[child].min, leafMin), max = glm::max(nodes[child].max, leafMax);
+            float childCost = AABBSurfaceArea(min, max);
+            if (!nodes[child].IsLeaf()) childCost -= AABBSurfaceArea(nodes[child].min, nodes[child].max);
+            return childCost + inheritance;
+        };
+
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = nodes[sibling].parent;
+    int32_t newParent = AllocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].min = glm::min(leafMin, nodes[sibling].min);
+    nodes[newParent].max = glm::max(leafMax, nodes[sibling].max);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent != AABBTreeNull) {
+        if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+        else                                    nodes[oldParent].child2 = newParent;
+    }
+    else {
+        root = newParent;
+    }
+
+    index = nodes[leaf].parent;
+    while (index != AABBTreeNull) {
+        index = Balance(index);
+
+        int32_t child1 = nodes[index].child1;
+        int32_t child2 = nodes[index].child2;
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        nodes[index].min = glm::min(nodes[child1].min, nodes[child2].min);
+        nodes[index].max = glm::max(nodes[child1].max, nodes[child2].max);
+
+        index = nodes[index].parent;
+    }
+}
+
+void AABBTree::RemoveLeaf(int32_t leaf) {
+
+    if (leaf == root) {
+        root = AABBTreeNull;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == AABBTreeNull) {
+        root = sibling;
+        nodes[sibling].parent = AABBTreeNull;
+        FreeNode(parent);
+        return;
+    }
+
+    if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+    else                                     nodes[grandParent].child2 = sibling;
+    nodes[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    int32_t index = grandParent;
+    while (index != AABBTreeNull) {
+        index = Balance(index);
+
+        int32_t child1 = nodes[index].child1;
+        int32_t child2 = nodes[index].child2;
+        nodes[index].min = glm::min(nodes[child1].min, nodes[child2].min);
+        nodes[index].max = glm::max(nodes[child1].max, nodes[child2].max);
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+
+        index = nodes[index].parent;
+    }
+}
+
+//------------------------------------------------------------------------------------------//
+// Rotations
+//------------------------------------------------------------------------------------------//
+
+// If one subtree of a is more than one level taller than the other, its taller child is
+// rotated up into a's place. Returns the index of the node now at a's position.
+int32_t AABBTree::Balance(int32_t a) {
+
+    AABBTreeNode& A = nodes[a];
+    if (A.IsLeaf() || A.height < 2) return a;
+
+    int32_t b = A.child1;
+    int32_t c = A.child2;
+    int32_t balance = nodes[c].height - nodes[b].height;
+    if (balance >= -1 && balance <= 1) return a;
+
+    // rotate the taller child `up` up, its taller grandchild stays under it and the other one
+    // moves under a
+    int32_t up   = balance > 1 ? c : b;
+    int32_t down = balance > 1 ? b : c;
+
+    int32_t f = nodes[up].child1;
+    int32_t g = nodes[up].child2;
+
+    nodes[up].child1 = a;
+    nodes[up].parent = nodes[a].parent;
+    nodes[a].parent = up;
+
+    if (nodes[up].parent != AABBTreeNull) {
+        if (nodes[nodes[up].parent].child1 == a) nodes[nodes[up].parent].child1 = up;
+        else                                     nodes[nodes[up].parent].child2 = up;
+    }
+    else {
+        root = up;
+    }
+
+    int32_t keep = nodes[f].height > nodes[g].height ? f : g;
+    int32_t move = keep == f ? g : f;
+
+    nodes[up].child2 = keep;
+    if (balance > 1) nodes[a].child2 = move;
+    else             nodes[a].child1 = move;
+    nodes[move].parent = a;
+
+    nodes[a].min = glm::min(nodes[down].min, nodes[move].min);
+    nodes[a].max = glm::max(nodes[down].max, nodes[move].max);
+    nodes[a].height = 1 + std::max(nodes[down].height, nodes[move].height);
+
+    nodes[up].min = glm::min(nodes[a].min, nodes[keep].min);
+    nodes[up].max = glm::max(nodes[a].max, nodes[keep].max);
+    nodes[up].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+
+    return up;
+}
+
+//------------------------------------------------------------------------------------------//
+// Query
+//------------------------------------------------------------------------------------------//
+
+// leaves are tested against their fat box, the exact bounds are tested before reporting
+void AABBTree::QueryObjects(const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) const {
+
+    if (root == AABBTreeNull) return;
+
+    thread_local std::vector<int32_t> pending;
+    pending.clear();
+    pending.push_back(root);
+
+    while (!pending.empty()) {
+        int32_t index = pending.back();
+        pending.pop_back();
+
+        const AABBTreeNode& node = nodes[index];
+        if (!AABBOverlaps(node.min, node.max, queryMin, queryMax)) continue;
+
+        if (node.IsLeaf()) {
+            glm::vec3 min, max;
+            node.object->GetWorldBounds(min, max);
+            if (AABBOverlaps(min, max, queryMin, queryMax)) results.push_back(node.object);
+        }
+        else {
+            pending.push_back(node.child1);
+            pending.push_back(node.child2);
+        }
+    }
+}
+
+}
+
+#endif /* aabb_tree_h */
@@ -47,7 +47,10 @@ public:
     glm::vec3 CalculateVelocity(glm::vec4 movement, float up, float down);
     glm::vec3 Step(glm::vec4 movement, float up, float down, float depth);
     
+    BoxShape shape = BoxShape(glm::vec3(0.5f));
+    
     std::vector<Vertex> GetColliderVertices();
+    ColliderView GetCollider();
     glm::mat4 CreateModelMatrix();
 };
 
@@ -179,6 +182,13 @@ std::vector<Vertex> Camera::GetColliderVertices() {
     return projectedVertices;
 }
 
+ColliderView Camera::GetCollider() {
+    
+    ColliderView view{&shape, ColliderTransform{}};
+    view.transform.translation = position;
+    return view;
+}
+
 glm::mat4 Camera::CreateModelMatrix() {
     
     glm::mat4 model = glm::mat4(1.0f);
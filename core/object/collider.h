@@ -0,0 +1,90 @@
+//
+//  collider.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-14.
+//
+
+#ifndef collider_h
+#define collider_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Collider transform
+//------------------------------------------------------------------------------------------//
+
+// model = translation * rotation * scale, kept decomposed so a support query can move the
+// search direction into local space instead of moving every vertex into world space
+struct ColliderTransform {
+    glm::mat3 rotation = glm::mat3(1.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+    glm::vec3 translation = glm::vec3(0.0f);
+    
+    // argmax d.(T + R*S*x) = argmax (S * R^T * d).x
+    glm::vec3 ToLocalDirection(const glm::vec3& direction) const {
+        return scale * (glm::transpose(rotation) * direction);
+    }
+    glm::vec3 ToWorldPoint(const glm::vec3& point) const {
+        return translation + rotation * (scale * point);
+    }
+};
+
+//------------------------------------------------------------------------------------------//
+// Collider view
+//------------------------------------------------------------------------------------------//
+
+// Non-owning view of a collider: a local-space shape plus the transform placing it in the world.
+// supportHint warm-starts hill-climbing shapes from the previous support vertex of the same query.
+struct ColliderView {
+    const Shape* shape;
+    ColliderTransform transform;
+    mutable uint32_t supportHint = 0;
+};
+
+//------------------------------------------------------------------------------------------//
+// Support
+//------------------------------------------------------------------------------------------//
+
+// the direction is moved into local space, so only the winning point is transformed
+glm::vec3 Support(const ColliderView& collider, glm::vec3 direction) {
+    glm::vec3 local = collider.shape->LocalSupport(collider.transform.ToLocalDirection(direction), collider.supportHint);
+    return collider.transform.ToWorldPoint(local);
+}
+
+//------------------------------------------------------------------------------------------//
+// Typed collider
+//------------------------------------------------------------------------------------------//
+
+// A collider whose shape type is known at compile time. The shape classes are final and the
+// calls below are qualified, so a support query is a direct, inlinable call instead of a
+// virtual one.
+template<typename ShapeT>
+struct TypedCollider {
+    const ShapeT* shape;
+    ColliderTransform transform;
+    mutable uint32_t supportHint = 0;
+    
+    // the view's shape must be a ShapeT
+    TypedCollider(const ColliderView& view) : shape(static_cast<const ShapeT*>(view.shape)), transform(view.transform), supportHint(view.supportHint) {}
+};
+
+template<typename ShapeT>
+glm::vec3 TypedLocalSupport(const ShapeT& shape, const glm::vec3& direction, uint32_t&) {
+    return shape.ShapeT::LocalSupport(direction);
+}
+
+// hulls are the only shapes that use the hint
+glm::vec3 TypedLocalSupport(const HullShape& shape, const glm::vec3& direction, uint32_t& hint) {
+    return shape.HullShape::LocalSupport(direction, hint);
+}
+
+template<typename ShapeT>
+glm::vec3 Support(const TypedCollider<ShapeT>& collider, glm::vec3 direction) {
+    glm::vec3 local = TypedLocalSupport(*collider.shape, collider.transform.ToLocalDirection(direction), collider.supportHint);
+    return collider.transform.ToWorldPoint(local);
+}
+
+}
+
+#endif /* collider_h */
@@ -65,6 +65,7 @@ RObject* Cube::Create() {
     
     cube->vertices = vertices;
     cube->indices = std::vector<uint32_t>();
+    cube->shape = std::make_unique<BoxShape>(glm::vec3(1.0f));
     
     cube->position = glm::vec3(0.0f, 0.0f, 0.0f);
     cube->rotation = glm::vec3(0.0f, 0.0f, 0.0f);
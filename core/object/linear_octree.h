@@ -0,0 +1,173 @@
+//
+//  linear_octree.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-18.
+//
+
+#ifndef linear_octree_h
+#define linear_octree_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Morton codes
+//------------------------------------------------------------------------------------------//
+
+// spreads the low 10 bits of v so there are two zero bits between each of them
+inline uint32_t ExpandMortonBits(uint32_t v) {
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v <<  8)) & 0x0300f00f;
+    v = (v | (v <<  4)) & 0x030c30c3;
+    v = (v | (v <<  2)) & 0x09249249;
+    return v;
+}
+
+inline uint32_t MortonCode(uint32_t x, uint32_t y, uint32_t z) {
+    return (ExpandMortonBits(z) << 2) | (ExpandMortonBits(y) << 1) | ExpandMortonBits(x);
+}
+
+//------------------------------------------------------------------------------------------//
+// Linear octree
+//------------------------------------------------------------------------------------------//
+
+constexpr int LinearOctreeLevels = 10;
+
+// Nodes are stored in pre-order, which for an octree split on Morton prefixes is Morton order:
+// a node's first child is the next node and `next` is the first node after its subtree. Every
+// subtree owns the contiguous range [firstObject, firstObject + objectCount) of the Morton-sorted
+// index array (objectMin/objectMax follow that order), and min/max enclose the bounds of those
+// objects rather than the octant, so an object crossing an octant boundary is still found.
+struct LinearOctreeNode {
+    glm::vec3 min, max;
+    uint32_t next;
+    uint32_t firstObject, objectCount;
+    uint32_t leaf;
+};
+
+class LinearOctree {
+public:
+    std::vector<LinearOctreeNode> nodes;
+    std::vector<uint32_t> indices;
+    std::vector<RObject*> objects;
+    std::vector<glm::vec3> objectMin, objectMax;
+
+    void Build(std::span<RObject* const> sceneObjects, uint32_t maxLeafObjects = 8);
+    void QueryObjects(const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) const;
+
+private:
+    std::vector<uint32_t> codes;
+
+    uint32_t BuildNode(uint32_t begin, uint32_t end, int level, uint32_t maxLeafObjects);
+};
+
+// O(n log n): one sort of the Morton codes, then each level splits its range with binary searches
+void LinearOctree::Build(std::span<RObject* const> sceneObjects, uint32_t maxLeafObjects) {
+
+    nodes.clear();
+    indices.clear();
+    codes.clear();
+    objects.assign(sceneObjects.begin(), sceneObjects.end());
+    objectMin.resize(objects.size());
+    objectMax.resize(objects.size());
+    if (objects.empty()) return;
+
+    glm::vec3 centerMin = glm::vec3(FLT_MAX), centerMax = glm::vec3(-FLT_MAX);
+    for (size_t i = 0; i < objects.size(); i++) {
+        objects[i]->GetWorldBounds(objectMin[i], objectMax[i]);
+        centerMin = glm::min(centerMin, objects[i]->position);
+        centerMax = glm::max(centerMax, objects[i]->position);
+    }
+
+    glm::vec3 extent = glm::max(centerMax - centerMin, glm::vec3(1e-6f));
+    float cells = float((1 << LinearOctreeLevels) - 1);
+
+    std::vector<std::pair<uint32_t, uint32_t>> sorted(objects.size());
+    for (uint32_t i = 0; i < objects.size(); i++) {
+        glm::vec3 cell = (objects[i]->position - centerMin) / extent * cells;
+        sorted[i] = {MortonCode((uint32_t)cell.x, (uint32_t)cell.y, (uint32_t)cell.z), i};
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    indices.resize(sorted.size());
+    codes.resize(sorted.size());
+    for (size_t i = 0; i < sorted.size(); i++) {
+        codes[i] = sorted[i].first;
+        indices[i] = sorted[i].second;
+    }
+
+    // bounds follow the sorted order so a leaf reads them contiguously
+    std::vector<glm::vec3> sortedMin(objects.size()), sortedMax(objects.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        sortedMin[i] = objectMin[indices[i]];
+        sortedMax[i] = objectMax[indices[i]];
+    }
+    objectMin.swap(sortedMin);
+    objectMax.swap(sortedMax);
+
+    BuildNode(0, (uint32_t)indices.size(), 0, std::max(maxLeafObjects, 1u));
+}
+
+uint32_t LinearOctree::BuildNode(uint32_t begin, uint32_t end, int level, uint32_t maxLeafObjects) {
+
+    uint32_t index = (uint32_t)nodes.size();
+    nodes.push_back(LinearOctreeNode{});
+
+    glm::vec3 min = glm::vec3(FLT_MAX), max = glm::vec3(-FLT_MAX);
+
+    if (end - begin <= maxLeafObjects || level == LinearOctreeLevels) {
+        for (uint32_t i = begin; i < end; i++) {
+            min = glm::min(min, objectMin[i]);
+            max = glm::max(max, objectMax[i]);
+        }
+        nodes[index].leaf = 1;
+    }
+    else {
+        // the codes in [begin, end) share their top 3 * level bits, the next 3 bits pick the octant
+        int shift = 3 * (LinearOctreeLevels - level - 1);
+        uint32_t start = begin;
+        while (start < end) {
+            uint32_t upper = ((codes[start] >> shift) + 1) << shift;
+            uint32_t stop = (uint32_t)(std::lower_bound(codes.begin() + start, codes.begin() + end, upper) - codes.begin());
+
+            uint32_t child = BuildNode(start, stop, level + 1, maxLeafObjects);
+            min = glm::min(min, nodes[child].min);
+            max = glm::max(max, nodes[child].max);
+            start = stop;
+        }
+        nodes[index].leaf = 0;
+    }
+
+    nodes[index].min = min;
+    nodes[index].max = max;
+    nodes[index].firstObject = begin;
+    nodes[index].objectCount = end - begin;
+    nodes[index].next = (uint32_t)nodes.size();
+
+    return index;
+}
+
+// stackless pre-order walk: descend into overlapping nodes, skip whole subtrees otherwise
+void LinearOctree::QueryObjects(const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) const {
+
+    uint32_t i = 0;
+    while (i < nodes.size()) {
+        const LinearOctreeNode& node = nodes[i];
+
+        if (!AABBOverlaps(node.min, node.max, queryMin, queryMax)) {
+            i = node.next;
+            continue;
+        }
+        if (node.leaf) {
+            for (uint32_t o = node.firstObject; o < node.firstObject + node.objectCount; o++) {
+                if (AABBOverlaps(objectMin[o], objectMax[o], queryMin, queryMax)) results.push_back(objects[indices[o]]);
+            }
+        }
+        i++;
+    }
+}
+
+}
+
+#endif /* linear_octree_h */
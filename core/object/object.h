@@ -19,11 +19,133 @@ public:
     
     glm::vec3 position, scale, rotation, color;
     
+    // collision shape in local space, a hull over the deduplicated vertices when left empty
+    std::unique_ptr<Shape> shape;
+    bool shapeFromVertices = false;
+    // vertex count the hull was built from, separate from the collider cache's own count
+    size_t shapeVertexCount = 0;
+    
+    // collider cache, rebuilt only when vertices or position/rotation/scale change
+    std::vector<glm::vec3> localCollider;
+    ColliderTransform colliderTransform;
+    glm::vec3 cachedPosition, cachedScale, cachedRotation;
+    size_t cachedVertexCount = 0;
+    bool transformCached = false;
+    
+    // world space bounds of the shape, rebuilt with the collider transform
+    glm::vec3 boundsMin, boundsMax;
+    bool boundsCached = false;
+    
     virtual void Render(Shader shader, GLenum renderingType, bool identityMatrix) {}
     std::vector<Vertex> GetColliderVertices(bool withNormals);
+    std::span<const glm::vec3> GetLocalCollider();
+    const ColliderTransform& GetColliderTransform();
+    const Shape* GetShape();
+    ColliderView GetCollider();
+    void GetWorldBounds(glm::vec3& min, glm::vec3& max);
+    glm::mat4 CreateRotationMatrix();
     glm::mat4 CreateModelMatrix();
 };
 
+//------------------------------------------------------------------------------------------//
+// Collider cache
+//------------------------------------------------------------------------------------------//
+
+// Removes the duplicated positions of a triangle soup (a cube has 36 vertices but only 8 corners)
+// while keeping the first occurrence order, so support ties resolve exactly as before
+std::vector<glm::vec3> DeduplicatePositions(const std::vector<Vertex>& vertices) {
+    
+    std::vector<uint32_t> order(vertices.size());
+    for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+    
+    auto less = [&](uint32_t i, uint32_t j) {
+        const glm::vec3& a = vertices[i].vertex;
+        const glm::vec3& b = vertices[j].vertex;
+        if (a.x != b.x) return a.x < b.x;
+        if (a.y != b.y) return a.y < b.y;
+        if (a.z != b.z) return a.z < b.z;
+        return i < j;
+    };
+    std::sort(order.begin(), order.end(), less);
+    
+    std::vector<uint32_t> unique;
+    unique.reserve(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        if (i == 0 || vertices[order[i]].vertex != vertices[order[i - 1]].vertex) unique.push_back(order[i]);
+    }
+    std::sort(unique.begin(), unique.end());
+    
+    std::vector<glm::vec3> positions;
+    positions.reserve(unique.size());
+    for (uint32_t i : unique) positions.push_back(vertices[i].vertex);
+    
+    return positions;
+}
+
+std::span<const glm::vec3> RObject::GetLocalCollider() {
+    
+    if (cachedVertexCount != vertices.size() || localCollider.empty()) {
+        localCollider = DeduplicatePositions(vertices);
+        cachedVertexCount = vertices.size();
+    }
+    return localCollider;
+}
+
+const ColliderTransform& RObject::GetColliderTransform() {
+    
+    if (transformCached && cachedPosition == position && cachedRotation == rotation && cachedScale == scale) {
+        return colliderTransform;
+    }
+    
+    colliderTransform.rotation = glm::mat3(CreateRotationMatrix());
+    colliderTransform.scale = scale;
+    colliderTransform.translation = position;
+    
+    cachedPosition = position;
+    cachedRotation = rotation;
+    cachedScale = scale;
+    transformCached = true;
+    boundsCached = false;
+    
+    return colliderTransform;
+}
+
+const Shape* RObject::GetShape() {
+    
+    if (!shape || (shapeFromVertices && shapeVertexCount != vertices.size())) {
+        std::span<const glm::vec3> local = GetLocalCollider();
+        shape = std::make_unique<HullShape>(std::vector<glm::vec3>(local.begin(), local.end()));
+        shapeFromVertices = true;
+        shapeVertexCount = vertices.size();
+        boundsCached = false;
+    }
+    return shape.get();
+}
+
+ColliderView RObject::GetCollider() {
+    return ColliderView{GetShape(), GetColliderTransform()};
+}
+
+// Exact AABB of the transformed shape from six support queries: the furthest point along +x
+// gives max.x and so on. For a box this is the usual OBB to AABB transform.
+void RObject::GetWorldBounds(glm::vec3& min, glm::vec3& max) {
+    
+    ColliderView collider = GetCollider();
+    
+    if (!boundsCached) {
+        for (int axis = 0; axis < 3; axis++) {
+            glm::vec3 direction = glm::vec3(0.0f);
+            direction[axis] = 1.0f;
+            boundsMax[axis] = Support(collider, direction)[axis];
+            boundsMin[axis] = Support(collider, -direction)[axis];
+        }
+        boundsCached = true;
+    }
+    
+    min = boundsMin;
+    max = boundsMax;
+}
+
 std::vector<Vertex> RObject::GetColliderVertices(bool withNormals = false) {
     
     glm::mat4 model = CreateModelMatrix();
@@ -38,6 +160,12 @@ std::vector<Vertex> RObject::GetColliderVertices(bool withNormals = false) {
     return projectedVertices;
 }
 
+glm::mat4 RObject::CreateRotationMatrix() {
+    return glm::rotate(glm::mat4(1.0f), glm::radians(rotation.x), glm::vec3(1, 0, 0)) *
+           glm::rotate(glm::mat4(1.0f), glm::radians(rotation.y), glm::vec3(0, 1, 0)) *
+           glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z), glm::vec3(0, 0, 1));
+}
+
 glm::mat4 RObject::CreateModelMatrix() {
     
     glm::mat4 model = glm::mat4(1.0f);
@@ -47,9 +175,7 @@ glm::mat4 RObject::CreateModelMatrix() {
     glm::mat4 scaleMatrix = glm::mat4(1.0f);
     scaleMatrix = glm::scale(scaleMatrix, scale);
     
-    glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(rotation.x), glm::vec3(1, 0, 0)) *
-                               glm::rotate(glm::mat4(1.0f), glm::radians(rotation.y), glm::vec3(0, 1, 0)) *
-                               glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z), glm::vec3(0, 0, 1));
+    glm::mat4 rotationMatrix = CreateRotationMatrix();
     
     model = translationMatrix * rotationMatrix * scaleMatrix;
     
@@ -14,6 +14,8 @@
 #include <mutex>
 #include <shared_mutex>
 #include <future>
+#include <chrono>
+#include <random>
 #include <algorithm>
 #include <glm/glm.hpp>
 
@@ -32,32 +34,16 @@ struct OctreeNode {
     OctreeNode() = default;
     OctreeNode(const glm::vec3& a, const glm::vec3& b) : min(a), max(b) {}
     ~OctreeNode() = default;
-
-    inline bool Intersects(const glm::vec3& amin, const glm::vec3& amax,
-                           const glm::vec3& bmin, const glm::vec3& bmax) const {
-        
-        return (amin.x <= bmax.x && amax.x >= bmin.x) &&
-               (amin.y <= bmax.y && amax.y >= bmin.y) &&
-               (amin.z <= bmax.z && amax.z >= bmin.z);
-    }
-
-    inline bool ContainsFully(const glm::vec3& amin, const glm::vec3& amax,
-                              const glm::vec3& bmin, const glm::vec3& bmax) const {
-
-        return (bmin.x >= amin.x && bmax.x <= amax.x) &&
-               (bmin.y >= amin.y && bmax.y <= amax.y) &&
-               (bmin.z >= amin.z && bmax.z <= amax.z);
-    }
 };
 
 inline void InsertObject(OctreeNode* node, RObject* obj, int depth = 0, int maxDepth = 6, int maxObjects = 8) {
     if (!node || !obj) return;
 
-    const glm::vec3 objMin = obj->position - obj->scale * 0.5f;
-    const glm::vec3 objMax = obj->position + obj->scale * 0.5f;
+    glm::vec3 objMin, objMax;
+    obj->GetWorldBounds(objMin, objMax);
     {
         std::shared_lock lock(node->nodeMutex);
-        if (!node->Intersects(node->min, node->max, objMin, objMax)) return;
+        if (!AABBOverlaps(node->min, node->max, objMin, objMax)) return;
     }
 
     {
@@ -69,7 +55,7 @@ inline void InsertObject(OctreeNode* node, RObject* obj, int depth = 0, int maxD
             for (int i = 0; i < 8; i++) {
                 OctreeNode* child = node->children[i].get();
                 if (!child) continue;
-                if (node->ContainsFully(child->min, child->max, objMin, objMax)) {
+                if (AABBContains(child->min, child->max, objMin, objMax)) {
                     containingIndex = i;
                     break;
                 }
@@ -108,14 +94,14 @@ inline void InsertObject(OctreeNode* node, RObject* obj, int depth = 0, int maxD
             std::vector<RObject*> remaining;
             remaining.reserve(node->objects.size());
             for (RObject* o : node->objects) {
-                const glm::vec3 oMin = o->position - o->scale * 0.5f;
-                const glm::vec3 oMax = o->position + o->scale * 0.5f;
+                glm::vec3 oMin, oMax;
+                o->GetWorldBounds(oMin, oMax);
 
                 int targetChild = -1;
                 for (int i = 0; i < 8; i++) {
                     OctreeNode* child = node->children[i].get();
                     if (!child) continue;
-                    if (node->ContainsFully(child->min, child->max, oMin, oMax)) {
+                    if (AABBContains(child->min, child->max, oMin, oMax)) {
                         targetChild = i;
                         break;
                     }
@@ -135,15 +121,15 @@ inline void InsertObject(OctreeNode* node, RObject* obj, int depth = 0, int maxD
             lock.unlock();
 
             for (RObject* o : oldObjects) {
-                const glm::vec3 oMin = o->position - o->scale * 0.5f;
-                const glm::vec3 oMax = o->position + o->scale * 0.5f;
+                glm::vec3 oMin, oMax;
+                o->GetWorldBounds(oMin, oMax);
 
                 int targetChild = -1;
                 
                 for (int i = 0; i < 8; i++) {
                     OctreeNode* child = node->children[i].get();
                     if (!child) continue;
-                    if (node->ContainsFully(child->min, child->max, oMin, oMax)) {
+                    if (AABBContains(child->min, child->max, oMin, oMax)) {
                         targetChild = i;
                         break;
                     }
@@ -165,13 +151,13 @@ inline void QueryObjects(OctreeNode* node, const glm::vec3& queryMin, const glm:
     if (!node) return;
 
     std::shared_lock lock1(node->nodeMutex);
-    if (!node->Intersects(node->min, node->max, queryMin, queryMax)) return;
+    if (!AABBOverlaps(node->min, node->max, queryMin, queryMax)) return;
 
     std::shared_lock lock2(node->nodeMutex);
     for (RObject* obj : node->objects) {
-        const glm::vec3 objMin = obj->position - obj->scale * 0.5f;
-        const glm::vec3 objMax = obj->position + obj->scale * 0.5f;
-        if (node->Intersects(objMin, objMax, queryMin, queryMax)) {
+        glm::vec3 objMin, objMax;
+        obj->GetWorldBounds(objMin, objMax);
+        if (AABBOverlaps(objMin, objMax, queryMin, queryMax)) {
             results.push_back(obj);
         }
     }
@@ -185,11 +171,89 @@ inline void QueryObjects(OctreeNode* node, const glm::vec3& queryMin, const glm:
     for (int i = 0; i < 8; i++) {
         OctreeNode* child = childRaw[i];
         if (!child) continue;
-        if (!child->Intersects(child->min, child->max, queryMin, queryMax)) continue;
+        if (!AABBOverlaps(child->min, child->max, queryMin, queryMax)) continue;
         QueryObjects(child, queryMin, queryMax, results);
     }
 }
 
+//------------------------------------------------------------------------------------------//
+// Parallel query
+//------------------------------------------------------------------------------------------//
+
+// Runs octree queries on a long-lived JobPool. Nodes above depthCutoff are visited inline; every
+// intersecting subtree rooted at depthCutoff becomes work, grainSize subtrees per task. Each task
+// fills its own buffer, which keeps its capacity across frames, and the buffers are appended in
+// task order so the result order is deterministic.
+class ParallelOctreeQuery {
+public:
+    JobPool& pool;
+    int depthCutoff;
+    size_t grainSize;
+    
+    ParallelOctreeQuery(JobPool& pool, int depthCutoff = 2, size_t grainSize = 4) : pool(pool), depthCutoff(depthCutoff), grainSize(grainSize) {}
+    
+    void Query(OctreeNode* root, const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results);
+    
+private:
+    std::vector<OctreeNode*> frontier;
+    std::vector<std::vector<RObject*>> taskResults;
+    
+    void CollectFrontier(OctreeNode* node, const glm::vec3& queryMin, const glm::vec3& queryMax, int depth, std::vector<RObject*>& results);
+};
+
+void ParallelOctreeQuery::CollectFrontier(OctreeNode* node, const glm::vec3& queryMin, const glm::vec3& queryMax, int depth, std::vector<RObject*>& results) {
+    
+    std::shared_lock lock(node->nodeMutex);
+    if (!AABBOverlaps(node->min, node->max, queryMin, queryMax)) return;
+    
+    if (depth >= depthCutoff || !node->children[0]) {
+        frontier.push_back(node);
+        return;
+    }
+    
+    for (RObject* obj : node->objects) {
+        glm::vec3 objMin, objMax;
+        obj->GetWorldBounds(objMin, objMax);
+        if (AABBOverlaps(objMin, objMax, queryMin, queryMax)) {
+            results.push_back(obj);
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        if (node->children[i]) CollectFrontier(node->children[i].get(), queryMin, queryMax, depth + 1, results);
+    }
+}
+
+void ParallelOctreeQuery::Query(OctreeNode* root, const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) {
+    
+    results.clear();
+    frontier.clear();
+    if (!root) return;
+    
+    CollectFrontier(root, queryMin, queryMax, 0, results);
+    
+    size_t grain = std::max<size_t>(grainSize, 1);
+    size_t taskCount = (frontier.size() + grain - 1) / grain;
+    if (taskResults.size() < taskCount) taskResults.resize(taskCount);
+    
+    pool.ParallelFor(frontier.size(), grain, [&](size_t begin, size_t end, unsigned) {
+        std::vector<RObject*>& buffer = taskResults[begin / grain];
+        buffer.clear();
+        for (size_t i = begin; i < end; i++) {
+            QueryObjects(frontier[i], queryMin, queryMax, buffer);
+        }
+    });
+    
+    for (size_t i = 0; i < taskCount; i++) {
+        results.insert(results.end(), taskResults[i].begin(), taskResults[i].end());
+    }
+}
+
+//------------------------------------------------------------------------------------------//
+// Reference query and benchmark
+//------------------------------------------------------------------------------------------//
+
+// The original parallel query, one std::async thread per intersecting child down to
+// parallelDepth. Kept as the baseline ParallelOctreeQuery is measured against.
 inline std::vector<RObject*> ParallelQuery(OctreeNode* root, const glm::vec3& minBox, const glm::vec3& maxBox, int parallelDepth = 1, int currentDepth = 0) {
     std::vector<RObject*> results;
 
@@ -203,12 +267,10 @@ inline std::vector<RObject*> ParallelQuery(OctreeNode* root, const glm::vec3& mi
 
     std::vector<std::future<std::vector<RObject*>>> futures;
     for (int i = 0; i < 8; ++i) {
-        OctreeNode* child = nullptr;
-        std::shared_lock lock(root->nodeMutex);
-        if (root->children[i]) child = root->children[i].get();
+        OctreeNode* child = root->children[i].get();
         if (!child) continue;
 
-        if (!child->Intersects(child->min, child->max, minBox, maxBox)) continue;
+        if (!AABBOverlaps(child->min, child->max, minBox, maxBox)) continue;
 
         futures.emplace_back(std::async(std::launch::async,
             [child, minBox, maxBox, parallelDepth, currentDepth]() -> std::vector<RObject*> {
@@ -216,16 +278,13 @@ inline std::vector<RObject*> ParallelQuery(OctreeNode* root, const glm::vec3& mi
             }));
     }
 
-    std::vector<RObject*> localResults;
-    std::shared_lock lock2(root->nodeMutex);
     for (RObject* obj : root->objects) {
-        const glm::vec3 objMin = obj->position - obj->scale * 0.5f;
-        const glm::vec3 objMax = obj->position + obj->scale * 0.5f;
-        if (root->Intersects(objMin, objMax, minBox, maxBox)) {
-            localResults.push_back(obj);
+        glm::vec3 objMin, objMax;
+        obj->GetWorldBounds(objMin, objMax);
+        if (AABBOverlaps(objMin, objMax, minBox, maxBox)) {
+            results.push_back(obj);
         }
     }
-    results.insert(results.end(), localResults.begin(), localResults.end());
 
     for (auto& fut : futures) {
         auto childRes = fut.get();
@@ -235,6 +294,179 @@ inline std::vector<RObject*> ParallelQuery(OctreeNode* root, const glm::vec3& mi
     return results;
 }
 
+struct OctreeQueryBenchmark {
+    // average latency per query
+    double referenceMicroseconds = 0.0, poolMicroseconds = 0.0;
+    size_t queries = 0, mismatches = 0;
+};
+
+// Times ParallelQuery against ParallelOctreeQuery on the same random boxes of side querySize
+// inside the root, and counts the queries where the two disagree on the set of objects found.
+// Object bounds are refreshed before timing starts so neither side pays for the caches.
+inline OctreeQueryBenchmark BenchmarkOctreeQuery(OctreeNode* root, ParallelOctreeQuery& query, size_t queries, float querySize, uint32_t seed = 1) {
+
+    OctreeQueryBenchmark result;
+    if (!root || queries == 0) return result;
+
+    std::mt19937 random(seed);
+    std::vector<glm::vec3> mins(queries);
+    for (glm::vec3& min : mins) {
+        for (int k = 0; k < 3; k++) {
+            std::uniform_real_distribution<float> axis(root->min[k], std::max(root->min[k], root->max[k] - querySize));
+            min[k] = axis(random);
+        }
+    }
+
+    std::vector<RObject*> warm;
+    QueryObjects(root, root->min, root->max, warm);
+
+    std::vector<std::vector<RObject*>> reference(queries), pooled(queries);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries; i++) reference[i] = ParallelQuery(root, mins[i], mins[i] + glm::vec3(querySize));
+    auto middle = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries; i++) query.Query(root, mins[i], mins[i] + glm::vec3(querySize), pooled[i]);
+    auto end = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < queries; i++) {
+        std::sort(reference[i].begin(), reference[i].end());
+        std::sort(pooled[i].begin(), pooled[i].end());
+        if (reference[i] != pooled[i]) result.mismatches++;
+    }
+
+    result.queries = queries;
+    result.referenceMicroseconds = std::chrono::duration<double, std::micro>(middle - start).count() / queries;
+    result.poolMicroseconds = std::chrono::duration<double, std::micro>(end - middle).count() / queries;
+    return result;
+}
+
+//------------------------------------------------------------------------------------------//
+// Self pairs
+//------------------------------------------------------------------------------------------//
+
+struct OctreePairObject {
+    RObject* object;
+    glm::vec3 min, max;
+};
+
+// Every object lives in exactly one node and is fully contained in it unless it sits in the
+// root, so a pair is found once: at the node of its deeper object, testing that node's objects
+// against each other and against the ancestor objects that overlap the node. stack[first..] holds
+// those ancestors with their bounds; each child receives the subset that overlaps its cell and
+// is handed to visitChild(child, childFirst).
+template<typename VisitChild>
+inline void WalkPairNode(OctreeNode* node, std::vector<OctreePairObject>& stack, size_t first, std::vector<CollisionPair>& pairs, VisitChild&& visitChild) {
+
+    std::shared_lock lock(node->nodeMutex);
+
+    size_t ancestorsEnd = stack.size();
+    for (RObject* obj : node->objects) {
+        OctreePairObject entry{obj, glm::vec3(0.0f), glm::vec3(0.0f)};
+        obj->GetWorldBounds(entry.min, entry.max);
+        for (size_t i = first; i < stack.size(); i++) {
+            if (AABBOverlaps(stack[i].min, stack[i].max, entry.min, entry.max)) {
+                pairs.push_back(CollisionPair{stack[i].object, obj});
+            }
+        }
+        stack.push_back(entry);
+    }
+
+    size_t ownEnd = stack.size();
+    for (int i = 0; i < 8; i++) {
+        OctreeNode* child = node->children[i].get();
+        if (!child) continue;
+
+        for (size_t j = first; j < ownEnd; j++) {
+            OctreePairObject entry = stack[j];
+            if (AABBOverlaps(child->min, child->max, entry.min, entry.max)) stack.push_back(entry);
+        }
+        visitChild(child, ownEnd);
+        stack.resize(ownEnd);
+    }
+    stack.resize(ancestorsEnd);
+}
+
+inline void CollectPairs(OctreeNode* node, std::vector<OctreePairObject>& stack, size_t first, std::vector<CollisionPair>& pairs) {
+    if (!node) return;
+
+    WalkPairNode(node, stack, first, pairs, [&](OctreeNode* child, size_t childFirst) {
+        CollectPairs(child, stack, childFirst, pairs);
+    });
+}
+
+// Enumerates every pair of objects in the tree whose bounds overlap, exactly once. Nodes above
+// depthCutoff are visited inline, the subtrees below them become jobs together with the ancestor
+// objects that overlap them. Buffers are appended in task order, so the pair order does not
+// depend on scheduling.
+class ParallelOctreePairs {
+public:
+    JobPool& pool;
+    int depthCutoff;
+    size_t grainSize;
+    
+    ParallelOctreePairs(JobPool& pool, int depthCutoff = 2, size_t grainSize = 4) : pool(pool), depthCutoff(depthCutoff), grainSize(grainSize) {}
+    
+    void Collect(OctreeNode* root, std::vector<CollisionPair>& pairs);
+    
+private:
+    struct FrontierNode {
+        OctreeNode* node;
+        size_t firstAncestor, ancestorCount;
+    };
+    
+    std::vector<FrontierNode> frontier;
+    std::vector<OctreePairObject> frontierAncestors;
+    std::vector<OctreePairObject> stack;
+    std::vector<std::vector<CollisionPair>> taskPairs;
+    std::vector<std::vector<OctreePairObject>> taskStacks;
+    
+    void CollectFrontier(OctreeNode* node, size_t first, int depth, std::vector<CollisionPair>& pairs);
+};
+
+void ParallelOctreePairs::CollectFrontier(OctreeNode* node, size_t first, int depth, std::vector<CollisionPair>& pairs) {
+    
+    if (depth >= depthCutoff) {
+        frontier.push_back(FrontierNode{node, frontierAncestors.size(), stack.size() - first});
+        frontierAncestors.insert(frontierAncestors.end(), stack.begin() + first, stack.end());
+        return;
+    }
+    
+    WalkPairNode(node, stack, first, pairs, [&](OctreeNode* child, size_t childFirst) {
+        CollectFrontier(child, childFirst, depth + 1, pairs);
+    });
+}
+
+void ParallelOctreePairs::Collect(OctreeNode* root, std::vector<CollisionPair>& pairs) {
+    
+    pairs.clear();
+    frontier.clear();
+    frontierAncestors.clear();
+    stack.clear();
+    if (!root) return;
+    
+    CollectFrontier(root, 0, 0, pairs);
+    
+    size_t grain = std::max<size_t>(grainSize, 1);
+    size_t taskCount = (frontier.size() + grain - 1) / grain;
+    if (taskPairs.size() < taskCount) taskPairs.resize(taskCount);
+    if (taskStacks.size() < taskCount) taskStacks.resize(taskCount);
+    
+    pool.ParallelFor(frontier.size(), grain, [&](size_t begin, size_t end, unsigned) {
+        std::vector<CollisionPair>& buffer = taskPairs[begin / grain];
+        std::vector<OctreePairObject>& taskStack = taskStacks[begin / grain];
+        buffer.clear();
+        for (size_t i = begin; i < end; i++) {
+            const FrontierNode& entry = frontier[i];
+            taskStack.assign(frontierAncestors.begin() + entry.firstAncestor, frontierAncestors.begin() + entry.firstAncestor + entry.ancestorCount);
+            CollectPairs(entry.node, taskStack, 0, buffer);
+        }
+    });
+    
+    for (size_t i = 0; i < taskCount; i++) {
+        pairs.insert(pairs.end(), taskPairs[i].begin(), taskPairs[i].end());
+    }
+}
+
 }
 
 #endif /* octree_node_h */
@@ -0,0 +1,144 @@
+//
+//  octree_snapshot.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-17.
+//
+
+#ifndef octree_snapshot_h
+#define octree_snapshot_h
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Snapshot
+//------------------------------------------------------------------------------------------//
+
+// Immutable, flattened copy of an OctreeNode tree. Children of a node are stored contiguously
+// from firstChild, and the objects of a node are the range [firstObject, firstObject + objectCount)
+// of the object arrays, with their bounds captured when the snapshot was taken.
+struct OctreeSnapshotNode {
+    glm::vec3 min, max;
+    uint32_t firstObject, objectCount;
+    uint32_t firstChild, childCount;
+};
+
+struct OctreeSnapshot {
+    std::vector<OctreeSnapshotNode> nodes;
+    std::vector<RObject*> objects;
+    std::vector<glm::vec3> objectMin, objectMax;
+};
+
+void FlattenOctreeNode(OctreeSnapshot& snapshot, uint32_t index, OctreeNode* node) {
+
+    std::shared_lock lock(node->nodeMutex);
+
+    OctreeSnapshotNode& flat = snapshot.nodes[index];
+    flat.min = node->min;
+    flat.max = node->max;
+    flat.firstObject = (uint32_t)snapshot.objects.size();
+    flat.objectCount = (uint32_t)node->objects.size();
+
+    for (RObject* obj : node->objects) {
+        glm::vec3 objMin, objMax;
+        obj->GetWorldBounds(objMin, objMax);
+        snapshot.objects.push_back(obj);
+        snapshot.objectMin.push_back(objMin);
+        snapshot.objectMax.push_back(objMax);
+    }
+
+    std::array<OctreeNode*, 8> children{};
+    uint32_t childCount = 0;
+    for (int i = 0; i < 8; i++) {
+        if (node->children[i]) children[childCount++] = node->children[i].get();
+    }
+
+    uint32_t firstChild = (uint32_t)snapshot.nodes.size();
+    snapshot.nodes.resize(snapshot.nodes.size() + childCount);
+    snapshot.nodes[index].firstChild = firstChild;
+    snapshot.nodes[index].childCount = childCount;
+
+    for (uint32_t i = 0; i < childCount; i++) {
+        FlattenOctreeNode(snapshot, firstChild + i, children[i]);
+    }
+}
+
+std::unique_ptr<OctreeSnapshot> BuildOctreeSnapshot(OctreeNode* root) {
+
+    std::unique_ptr<OctreeSnapshot> snapshot = std::make_unique<OctreeSnapshot>();
+    if (!root) return snapshot;
+
+    snapshot->nodes.resize(1);
+    FlattenOctreeNode(*snapshot, 0, root);
+
+    return snapshot;
+}
+
+void QuerySnapshot(const OctreeSnapshot& snapshot, uint32_t index, const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) {
+
+    const OctreeSnapshotNode& node = snapshot.nodes[index];
+
+    for (uint32_t i = node.firstObject; i < node.firstObject + node.objectCount; i++) {
+        if (AABBOverlaps(snapshot.objectMin[i], snapshot.objectMax[i], queryMin, queryMax)) {
+            results.push_back(snapshot.objects[i]);
+        }
+    }
+
+    for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+        const OctreeSnapshotNode& child = snapshot.nodes[i];
+        if (AABBOverlaps(child.min, child.max, queryMin, queryMax)) {
+            QuerySnapshot(snapshot, i, queryMin, queryMax, results);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------//
+// Static octree
+//------------------------------------------------------------------------------------------//
+
+// Lock-free read path for the static part of a scene, e.g. terrain colliders. Readers load the
+// current snapshot with one atomic acquire and never touch a mutex. Publish() swaps in a new
+// snapshot RCU-style and retires the old one; retired snapshots are freed by Reclaim(), which
+// the writer must only call at a point where no query is in flight (e.g. between frames).
+// Dynamic objects keep living in a regular, locked OctreeNode next to this one.
+class StaticOctree {
+public:
+    StaticOctree() = default;
+    StaticOctree(const StaticOctree&) = delete;
+    StaticOctree& operator=(const StaticOctree&) = delete;
+
+    void Publish(std::unique_ptr<OctreeSnapshot> snapshot);
+    void Reclaim();
+    void QueryObjects(const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) const;
+
+private:
+    std::atomic<const OctreeSnapshot*> current{nullptr};
+    std::unique_ptr<OctreeSnapshot> published;
+    std::vector<std::unique_ptr<OctreeSnapshot>> retired;
+};
+
+void StaticOctree::Publish(std::unique_ptr<OctreeSnapshot> snapshot) {
+
+    current.store(snapshot.get(), std::memory_order_release);
+    if (published) retired.push_back(std::move(published));
+    published = std::move(snapshot);
+}
+
+void StaticOctree::Reclaim() {
+    retired.clear();
+}
+
+void StaticOctree::QueryObjects(const glm::vec3& queryMin, const glm::vec3& queryMax, std::vector<RObject*>& results) const {
+
+    const OctreeSnapshot* snapshot = current.load(std::memory_order_acquire);
+    if (!snapshot || snapshot->nodes.empty()) return;
+
+    const OctreeSnapshotNode& root = snapshot->nodes[0];
+    if (AABBOverlaps(root.min, root.max, queryMin, queryMax)) {
+        QuerySnapshot(*snapshot, 0, queryMin, queryMax, results);
+    }
+}
+
+}
+
+#endif /* octree_snapshot_h */
@@ -0,0 +1,239 @@
+//
+//  sweep_and_prune.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-19.
+//
+
+#ifndef sweep_and_prune_h
+#define sweep_and_prune_h
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace core {
+
+//------------------------------------------------------------------------------------------//
+// Pairs
+//------------------------------------------------------------------------------------------//
+
+// a < b, so every overlapping pair has exactly one key
+struct SweepPair {
+    RObject* a;
+    RObject* b;
+
+    SweepPair(RObject* x, RObject* y) : a(std::min(x, y, std::less<RObject*>())), b(std::max(x, y, std::less<RObject*>())) {}
+    bool operator==(const SweepPair& other) const { return a == other.a && b == other.b; }
+};
+
+struct SweepPairHash {
+    size_t operator()(const SweepPair& pair) const {
+        size_t h = std::hash<RObject*>()(pair.a);
+        return h ^ (std::hash<RObject*>()(pair.b) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+    }
+};
+
+struct SweepPairEvent {
+    RObject* a;
+    RObject* b;
+    bool added;
+};
+
+//------------------------------------------------------------------------------------------//
+// Sweep and prune
+//------------------------------------------------------------------------------------------//
+
+// Sort-and-sweep broad phase. Every axis keeps the min and max endpoints of all proxies sorted,
+// and Update() re-sorts them with insertion sort, which is close to O(n) when objects move a
+// little each frame. A pair starts overlapping when a min endpoint passes a max endpoint and
+// stops when a max passes a min, so the overlap set is maintained by the swaps alone.
+class SweepAndPrune {
+public:
+    // currently overlapping pairs
+    std::unordered_set<SweepPair, SweepPairHash> pairs;
+
+    void Add(RObject* obj);
+    void Remove(RObject* obj);
+    // refreshes every bound, re-sorts the axes and appends the net pair changes since the last call
+    void Update(std::vector<SweepPairEvent>& events);
+
+private:
+    struct Endpoint {
+        float value;
+        uint32_t proxy;
+        uint32_t isMax;
+    };
+    struct Proxy {
+        RObject* object;
+        glm::vec3 min, max;
+    };
+
+    std::vector<Endpoint> axes[3];
+    std::vector<Proxy> proxies;
+    std::vector<uint32_t> freeProxies;
+    std::unordered_map<RObject*, uint32_t> proxyOf;
+    // state of every pair touched since the last Update(), before it was first touched
+    std::unordered_map<SweepPair, bool, SweepPairHash> touched;
+
+    static bool Less(const Endpoint& a, const Endpoint& b);
+    void Swapped(const Endpoint& moved, const Endpoint& passed, bool movedLeft);
+    void SiftLeft(std::vector<Endpoint>& axis, size_t index);
+    void SiftRight(std::vector<Endpoint>& axis, size_t index);
+    void SetPair(uint32_t p, uint32_t q, bool overlapping);
+};
+
+// at equal values mins come first, so touching boxes count as overlapping like in AABBOverlaps
+bool SweepAndPrune::Less(const Endpoint& a, const Endpoint& b) {
+    return a.value < b.value || (a.value == b.value && !a.isMax && b.isMax);
+}
+
+void SweepAndPrune::SetPair(uint32_t p, uint32_t q, bool overlapping) {
+
+    SweepPair pair(proxies[p].object, proxies[q].object);
+    bool present = pairs.count(pair) > 0;
+    if (present == overlapping) return;
+
+    touched.try_emplace(pair, present);
+    if (overlapping) pairs.insert(pair);
+    else             pairs.erase(pair);
+}
+
+// `moved` has just been swapped past `passed`. Only a min/max crossing changes overlap on this
+// axis; a new overlap is confirmed on all three axes with the current bounds.
+void SweepAndPrune::Swapped(const Endpoint& moved, const Endpoint& passed, bool movedLeft) {
+
+    if (moved.isMax == passed.isMax || moved.proxy == passed.proxy) return;
+
+    // moving a min left past a max, or a max right past a min, brings the intervals together
+    bool entering = movedLeft ? !moved.isMax : moved.isMax;
+    if (entering) {
+        const Proxy& p = proxies[moved.proxy];
+        const Proxy& q = proxies[passed.proxy];
+        if (AABBOverlaps(p.min, p.max, q.min, q.max)) SetPair(moved.proxy, passed.proxy, true);
+    }
+    else {
+        SetPair(moved.proxy, passed.proxy, false);
+    }
+}
+
+void SweepAndPrune::SiftLeft(std::vector<Endpoint>& axis, size_t index) {
+
+    Endpoint endpoint = axis[index];
+    while (index > 0 && Less(endpoint, axis[index - 1])) {
+        Swapped(endpoint, axis[index - 1], true);
+        axis[index] = axis[index - 1];
+        index--;
+    }
+    axis[index] = endpoint;
+}
+
+void SweepAndPrune::SiftRight(std::vector<Endpoint>& axis, size_t index) {
+
+    Endpoint endpoint = axis[index];
+    while (index + 1 < axis.size() && Less(axis[index + 1], endpoint)) {
+        Swapped(endpoint, axis[index + 1], false);
+        axis[index] = axis[index + 1];
+        index++;
+    }
+    axis[index] = endpoint;
+}
+
+//------------------------------------------------------------------------------------------//
+// Add / remove
+//------------------------------------------------------------------------------------------//
+
+// the endpoints are appended behind everything else and sifted into place, min first so it never
+// meets its own max, and the crossings report exactly the pairs the object overlaps
+void SweepAndPrune::Add(RObject* obj) {
+
+    if (!obj || proxyOf.count(obj)) return;
+
+    uint32_t proxy;
+    if (!freeProxies.empty()) {
+        proxy = freeProxies.back();
+        freeProxies.pop_back();
+    }
+    else {
+        proxy = (uint32_t)proxies.size();
+        proxies.push_back(Proxy{});
+    }
+    proxies[proxy].object = obj;
+    obj->GetWorldBounds(proxies[proxy].min, proxies[proxy].max);
+    proxyOf[obj] = proxy;
+
+    for (int a = 0; a < 3; a++) {
+        std::vector<Endpoint>& axis = axes[a];
+        axis.push_back(Endpoint{proxies[proxy].min[a], proxy, 0});
+        SiftLeft(axis, axis.size() - 1);
+        axis.push_back(Endpoint{proxies[proxy].max[a], proxy, 1});
+        SiftLeft(axis, axis.size() - 1);
+    }
+}
+
+// the reverse of Add(): the endpoints are pushed to +infinity, dropping every pair on the way
+void SweepAndPrune::Remove(RObject* obj) {
+
+    auto it = proxyOf.find(obj);
+    if (it == proxyOf.end()) return;
+
+    uint32_t proxy = it->second;
+    proxies[proxy].min = glm::vec3(FLT_MAX);
+    proxies[proxy].max = glm::vec3(FLT_MAX);
+
+    for (int a = 0; a < 3; a++) {
+        std::vector<Endpoint>& axis = axes[a];
+
+        for (size_t i = axis.size(); i-- > 0;) {
+            if (axis[i].proxy == proxy && axis[i].isMax) {
+                axis[i].value = FLT_MAX;
+                SiftRight(axis, i);
+                break;
+            }
+        }
+        for (size_t i = axis.size(); i-- > 0;) {
+            if (axis[i].proxy == proxy && !axis[i].isMax) {
+                axis[i].value = FLT_MAX;
+                SiftRight(axis, i);
+                break;
+            }
+        }
+        axis.resize(axis.size() - 2);
+    }
+
+    proxies[proxy].object = nullptr;
+    freeProxies.push_back(proxy);
+    proxyOf.erase(it);
+}
+
+//------------------------------------------------------------------------------------------//
+// Update
+//------------------------------------------------------------------------------------------//
+
+void SweepAndPrune::Update(std::vector<SweepPairEvent>& events) {
+
+    for (Proxy& proxy : proxies) {
+        if (proxy.object) proxy.object->GetWorldBounds(proxy.min, proxy.max);
+    }
+
+    for (int a = 0; a < 3; a++) {
+        std::vector<Endpoint>& axis = axes[a];
+        for (Endpoint& endpoint : axis) {
+            const Proxy& proxy = proxies[endpoint.proxy];
+            endpoint.value = endpoint.isMax ? proxy.max[a] : proxy.min[a];
+        }
+        for (size_t i = 1; i < axis.size(); i++) {
+            if (Less(axis[i], axis[i - 1])) SiftLeft(axis, i);
+        }
+    }
+
+    // a pair that was added and removed again in the same frame produces no event
+    for (const auto& [pair, wasPresent] : touched) {
+        bool present = pairs.count(pair) > 0;
+        if (present != wasPresent) events.push_back(SweepPairEvent{pair.a, pair.b, present});
+    }
+    touched.clear();
+}
+
+}
+
+#endif /* sweep_and_prune_h */
@@ -165,6 +165,12 @@ RObject* Terrain::Create() {
 
             col->position = center;
             col->scale = glm::vec3(1.0f);
+            col->rotation = glm::vec3(0.0f);
+            
+            // hull vertices with adjacency, support queries walk the hull instead of scanning it
+            std::unique_ptr<HullShape> hull = std::make_unique<HullShape>(DeduplicatePositions(col->vertices));
+            hull->BuildAdjacency();
+            col->shape = std::move(hull);
 
             static_cast<Terrain*>(terrain)->colliders.push_back(col);
         }
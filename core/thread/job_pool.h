@@ -0,0 +1,182 @@
+//
+//  job_pool.h
+//  GJK
+//
+//  Created by Dmitri Wamback on 2025-11-16.
+//
+
+#ifndef job_pool_h
+#define job_pool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace core {
+
+// Counts the jobs of one submission batch that have not finished yet
+struct TaskGroup {
+    std::atomic<int> pending{0};
+};
+
+//------------------------------------------------------------------------------------------//
+// Job pool
+//------------------------------------------------------------------------------------------//
+
+// Persistent worker threads with one deque each. A worker pops its own deque from the back and
+// steals from the front of the others. Threads outside the pool push to an extra shared deque
+// and help run jobs while they Wait(), so nested submissions never deadlock.
+class JobPool {
+public:
+    using Job = std::function<void()>;
+
+    JobPool(unsigned threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    void Submit(TaskGroup& group, Job job);
+    void Wait(TaskGroup& group);
+
+    // calls fn(begin, end, slot) over [0, count) in chunks of grainSize, slot is CurrentSlot()
+    template<typename F>
+    void ParallelFor(size_t count, size_t grainSize, F&& fn);
+
+    unsigned WorkerCount() const { return (unsigned)workers.size(); }
+    // 0 .. WorkerCount() - 1 inside workers, WorkerCount() for every other thread
+    unsigned SlotCount() const { return WorkerCount() + 1; }
+    unsigned CurrentSlot() const;
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<int> queued{0};
+    bool running = true;
+
+    bool TryRunOne(unsigned slot);
+    void WorkerLoop(unsigned slot);
+};
+
+inline thread_local const JobPool* currentJobPool = nullptr;
+inline thread_local unsigned currentJobSlot = 0;
+
+JobPool::JobPool(unsigned threadCount) {
+
+    for (unsigned i = 0; i < threadCount + 1; i++) queues.push_back(std::make_unique<WorkQueue>());
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+JobPool::~JobPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    sleepCondition.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+unsigned JobPool::CurrentSlot() const {
+    return currentJobPool == this ? currentJobSlot : WorkerCount();
+}
+
+void JobPool::Submit(TaskGroup& group, Job job) {
+
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+
+    WorkQueue& queue = *queues[CurrentSlot()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.emplace_back([&group, job = std::move(job)]() {
+            job();
+            group.pending.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued.fetch_add(1, std::memory_order_release);
+    }
+    sleepCondition.notify_one();
+}
+
+bool JobPool::TryRunOne(unsigned slot) {
+
+    Job job;
+    {
+        WorkQueue& own = *queues[slot];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+        }
+    }
+    for (unsigned i = 1; !job && i < queues.size(); i++) {
+        WorkQueue& victim = *queues[(slot + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+        }
+    }
+    if (!job) return false;
+
+    queued.fetch_sub(1, std::memory_order_acq_rel);
+    job();
+    return true;
+}
+
+void JobPool::WorkerLoop(unsigned slot) {
+
+    currentJobPool = this;
+    currentJobSlot = slot;
+
+    while (true) {
+        if (TryRunOne(slot)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]() { return !running || queued.load(std::memory_order_acquire) > 0; });
+        if (!running) return;
+    }
+}
+
+void JobPool::Wait(TaskGroup& group) {
+
+    unsigned slot = CurrentSlot();
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+        if (!TryRunOne(slot)) std::this_thread::yield();
+    }
+}
+
+template<typename F>
+void JobPool::ParallelFor(size_t count, size_t grainSize, F&& fn) {
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (count <= grainSize) {
+        fn(size_t(0), count, CurrentSlot());
+        return;
+    }
+
+    TaskGroup group;
+    for (size_t begin = 0; begin < count; begin += grainSize) {
+        size_t end = std::min(begin + grainSize, count);
+        Submit(group, [this, &fn, begin, end]() { fn(begin, end, CurrentSlot()); });
+    }
+    Wait(group);
+}
+
+}
+
+#endif /* job_pool_h */